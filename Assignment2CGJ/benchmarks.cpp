@@ -0,0 +1,392 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Benchmarks
+//
+// Headless measurements of the mgl rendering paths, run from the demo with
+//
+//   hello-2d-world --bench <name>
+//
+// GPU benchmarks drive the Engine in headless mode for a fixed number of
+// frames and time each phase with a GPU profiler zone; every phase is
+// preceded by warm-up frames that are not timed. CPU benchmarks need no
+// context and are timed with a steady clock. Results are printed to the
+// standard output when the run ends.
+//
+// Copyright (c) 2013-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./benchmarks.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../mgl/mgl.hpp"
+
+static const int WARMUP_FRAMES = 10;
+static const int TIMED_FRAMES = 100;
+static const int PHASE_FRAMES = WARMUP_FRAMES + TIMED_FRAMES;
+
+const GLuint POSITION = 0, COLOR = 1, INSTANCE = 2;
+
+static void printZone(const char *label,
+                      const mgl::Profiler::FrameStats &stats,
+                      const char *zone) {
+  for (const mgl::Profiler::ZoneStats &z : stats.zones) {
+    if (std::strcmp(z.name, zone) == 0) {
+      std::cout << std::left << std::setw(28) << label << std::right
+                << std::fixed << std::setprecision(3) << std::setw(10)
+                << z.cpu_ms << " ms cpu" << std::setw(10) << z.gpu_ms
+                << " ms gpu" << std::endl;
+    }
+  }
+}
+
+static mgl::MeshBuilder::Mesh createTriangle() {
+  const GLfloat vertices[3][8] = {{-0.5f, -0.5f, 0.0f, 1.0f, 1, 0, 0, 1},
+                                  {0.5f, -0.5f, 0.0f, 1.0f, 0, 1, 0, 1},
+                                  {0.0f, 0.5f, 0.0f, 1.0f, 0, 0, 1, 1}};
+  const GLubyte indices[] = {0, 1, 2};
+  mgl::VertexFormat format;
+  format.addPosition(POSITION).addColor(COLOR);
+  std::vector<GLubyte> packed(format.getStride() * 3);
+  for (size_t i = 0; i < 3; ++i) {
+    GLubyte *vertex = packed.data() + i * format.getStride();
+    format.pack(vertex, 0, glm::make_vec4(vertices[i]));
+    format.pack(vertex, 1, glm::make_vec4(vertices[i] + 4));
+  }
+  return mgl::MeshBuilder(format)
+      .setVertices(packed.data(), 3)
+      .setIndices(indices, 3, GL_UNSIGNED_BYTE)
+      .build();
+}
+
+//////////////////////////////////////////////////////////////////// INSTANCING
+
+// Draws N copies of a triangle laid out on a grid covering clip space, first
+// with one setMat4 + glDrawElements per object and then with one
+// InstanceBatch upload + glDrawElementsInstanced, for N = 1k, 10k and 100k.
+
+class InstancingBenchmark : public mgl::App {
+public:
+  void initCallback(GLFWwindow *win) override;
+  void displayCallback(GLFWwindow *win, double elapsed) override;
+  void windowCloseCallback(GLFWwindow *win) override;
+
+  static const int PHASES = 6;
+
+private:
+  std::unique_ptr<mgl::ShaderProgram> PerObject, Instanced;
+  mgl::ShaderProgram::UniformHandle MatrixId;
+  mgl::MeshBuilder::Mesh Triangle;
+  mgl::InstanceBatch Batch;
+  std::vector<glm::mat4> Models;
+  mgl::Profiler::ZoneId Zones[PHASES];
+  int Frame = 0;
+};
+
+static const char *const INSTANCING_PHASES[] = {
+    "per-object 1k", "instanced 1k",   "per-object 10k",
+    "instanced 10k", "per-object 100k", "instanced 100k"};
+static const size_t INSTANCING_COUNTS[] = {1000, 10000, 100000};
+
+void InstancingBenchmark::initCallback(GLFWwindow *win) {
+  PerObject = std::make_unique<mgl::ShaderProgram>();
+  PerObject->addShader(GL_VERTEX_SHADER, "clip-vs.glsl");
+  PerObject->addShader(GL_FRAGMENT_SHADER, "clip-fs.glsl");
+  PerObject->addAttribute(mgl::POSITION_ATTRIBUTE, POSITION);
+  PerObject->addAttribute(mgl::COLOR_ATTRIBUTE, COLOR);
+  MatrixId = PerObject->addUniform("Matrix");
+  PerObject->create();
+
+  Instanced = std::make_unique<mgl::ShaderProgram>();
+  Instanced->addShader(GL_VERTEX_SHADER, "instanced-vs.glsl");
+  Instanced->addShader(GL_FRAGMENT_SHADER, "clip-fs.glsl");
+  Instanced->addAttribute(mgl::POSITION_ATTRIBUTE, POSITION);
+  Instanced->addAttribute(mgl::COLOR_ATTRIBUTE, COLOR);
+  Instanced->addAttribute(mgl::INSTANCE_MATRIX_ATTRIBUTE, INSTANCE);
+  Instanced->addAttribute(mgl::INSTANCE_COLOR_ATTRIBUTE, INSTANCE + 4);
+  Instanced->create();
+
+  Triangle = createTriangle();
+  Batch.create(mgl::Resources::getInstance().get(Triangle.vao), INSTANCE);
+
+  const size_t n = INSTANCING_COUNTS[2];
+  const int side = static_cast<int>(std::ceil(std::sqrt(double(n))));
+  const GLfloat cell = 2.0f / side;
+  Models.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const glm::vec3 center(-1.0f + cell * (i % side + 0.5f),
+                           -1.0f + cell * (i / side + 0.5f), 0.0f);
+    Models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), center),
+                                glm::vec3(cell)));
+  }
+
+  mgl::Profiler &profiler = mgl::Engine::getInstance().getProfiler();
+  profiler.setEnabled(true);
+  for (int p = 0; p < PHASES; ++p) {
+    Zones[p] = profiler.registerZone(INSTANCING_PHASES[p]);
+  }
+}
+
+void InstancingBenchmark::displayCallback(GLFWwindow *win, double elapsed) {
+  const int phase = Frame / PHASE_FRAMES;
+  const bool timed = Frame % PHASE_FRAMES >= WARMUP_FRAMES;
+  Frame++;
+  if (phase >= PHASES) {
+    return;
+  }
+  const size_t n = INSTANCING_COUNTS[phase / 2];
+  mgl::Resources &resources = mgl::Resources::getInstance();
+  mgl::Profiler &profiler = mgl::Engine::getInstance().getProfiler();
+  if (timed) {
+    profiler.beginZone(Zones[phase], true);
+  }
+  if (phase % 2 == 0) {
+    mgl::StateCache::getInstance().bindVertexArray(
+        resources.get(Triangle.vao));
+    PerObject->bind();
+    for (size_t i = 0; i < n; ++i) {
+      PerObject->setMat4(MatrixId, Models[i]);
+      glDrawElements(GL_TRIANGLES, Triangle.index_count, Triangle.index_type,
+                     reinterpret_cast<GLvoid *>(0));
+    }
+  } else {
+    Instanced->bind();
+    Batch.clear();
+    for (size_t i = 0; i < n; ++i) {
+      Batch.add(Models[i], glm::vec4(1.0f));
+    }
+    Batch.draw(GL_TRIANGLES, Triangle.index_count, Triangle.index_type);
+  }
+  if (timed) {
+    profiler.endZone();
+  }
+}
+
+void InstancingBenchmark::windowCloseCallback(GLFWwindow *win) {
+  const mgl::Profiler::FrameStats stats =
+      mgl::Engine::getInstance().getProfiler().getStats();
+  std::cout << "Instancing: average per frame over " << TIMED_FRAMES
+            << " frames" << std::endl;
+  for (int p = 0; p < PHASES; ++p) {
+    printZone(INSTANCING_PHASES[p], stats, INSTANCING_PHASES[p]);
+  }
+  Batch.destroy();
+  mgl::MeshBuilder::destroy(Triangle);
+}
+
+////////////////////////////////////////////////////////////////// VERTEXFORMAT
+
+// Streams 1M and 4M points through the vertex stage with rasterization
+// discarded, so vertex fetch dominates, once with vec4 float positions and
+// colors (32 bytes per vertex) and once with the compact half position and
+// normalized byte color presets (12 bytes per vertex). Every frame draws each
+// mesh DRAWS times.
+
+class VertexFormatBenchmark : public mgl::App {
+public:
+  void initCallback(GLFWwindow *win) override;
+  void displayCallback(GLFWwindow *win, double elapsed) override;
+  void windowCloseCallback(GLFWwindow *win) override;
+
+  static const int PHASES = 4;
+  static const int DRAWS = 8;
+
+private:
+  std::unique_ptr<mgl::ShaderProgram> Program;
+  mgl::ShaderProgram::UniformHandle MatrixId;
+  mgl::MeshBuilder::Mesh Meshes[PHASES];
+  mgl::Profiler::ZoneId Zones[PHASES];
+  int Frame = 0;
+};
+
+static const char *const VERTEXFORMAT_PHASES[] = {
+    "float 32B 1M", "compact 12B 1M", "float 32B 4M", "compact 12B 4M"};
+static const GLsizei VERTEXFORMAT_COUNTS[] = {1 << 20, 1 << 22};
+
+static mgl::MeshBuilder::Mesh createPoints(const mgl::VertexFormat &format,
+                                           const GLsizei count) {
+  std::vector<GLubyte> packed(size_t(format.getStride()) * count);
+  uint32_t seed = 12345;
+  auto random = [&seed] {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / GLfloat(1 << 24);
+  };
+  for (GLsizei i = 0; i < count; ++i) {
+    GLubyte *vertex = packed.data() + size_t(i) * format.getStride();
+    format.pack(vertex, 0,
+                glm::vec4(random() * 2 - 1, random() * 2 - 1, 0.0f, 1.0f));
+    format.pack(vertex, 1, glm::vec4(random(), random(), random(), 1.0f));
+  }
+  return mgl::MeshBuilder(format).setVertices(packed.data(), count).build();
+}
+
+void VertexFormatBenchmark::initCallback(GLFWwindow *win) {
+  Program = std::make_unique<mgl::ShaderProgram>();
+  Program->addShader(GL_VERTEX_SHADER, "clip-vs.glsl");
+  Program->addShader(GL_FRAGMENT_SHADER, "clip-fs.glsl");
+  Program->addAttribute(mgl::POSITION_ATTRIBUTE, POSITION);
+  Program->addAttribute(mgl::COLOR_ATTRIBUTE, COLOR);
+  MatrixId = Program->addUniform("Matrix");
+  Program->create();
+
+  mgl::VertexFormat full, compact;
+  full.add(POSITION, 4, GL_FLOAT).add(COLOR, 4, GL_FLOAT);
+  compact.addPosition(POSITION).addColor(COLOR);
+  for (int p = 0; p < PHASES; ++p) {
+    Meshes[p] = createPoints(p % 2 == 0 ? full : compact,
+                             VERTEXFORMAT_COUNTS[p / 2]);
+  }
+
+  mgl::Profiler &profiler = mgl::Engine::getInstance().getProfiler();
+  profiler.setEnabled(true);
+  for (int p = 0; p < PHASES; ++p) {
+    Zones[p] = profiler.registerZone(VERTEXFORMAT_PHASES[p]);
+  }
+}
+
+void VertexFormatBenchmark::displayCallback(GLFWwindow *win, double elapsed) {
+  const int phase = Frame / PHASE_FRAMES;
+  const bool timed = Frame % PHASE_FRAMES >= WARMUP_FRAMES;
+  Frame++;
+  if (phase >= PHASES) {
+    return;
+  }
+  mgl::StateCache &state = mgl::StateCache::getInstance();
+  mgl::Profiler &profiler = mgl::Engine::getInstance().getProfiler();
+  Program->bind();
+  Program->setMat4(MatrixId, glm::mat4(1.0f));
+  state.bindVertexArray(mgl::Resources::getInstance().get(Meshes[phase].vao));
+  state.enable(GL_RASTERIZER_DISCARD);
+  if (timed) {
+    profiler.beginZone(Zones[phase], true);
+  }
+  for (int d = 0; d < DRAWS; ++d) {
+    glDrawArrays(GL_POINTS, 0, Meshes[phase].vertex_count);
+  }
+  if (timed) {
+    profiler.endZone();
+  }
+  state.disable(GL_RASTERIZER_DISCARD);
+}
+
+void VertexFormatBenchmark::windowCloseCallback(GLFWwindow *win) {
+  const mgl::Profiler::FrameStats stats =
+      mgl::Engine::getInstance().getProfiler().getStats();
+  std::cout << "Vertex format: average per frame of " << DRAWS
+            << " draws over " << TIMED_FRAMES << " frames" << std::endl;
+  for (int p = 0; p < PHASES; ++p) {
+    printZone(VERTEXFORMAT_PHASES[p], stats, VERTEXFORMAT_PHASES[p]);
+    mgl::MeshBuilder::destroy(Meshes[p]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////// SCENEGRAPH
+
+// Times SceneGraph::update() on trees of 10k and 100k nodes with a branching
+// factor of 8: the initial full update, an idle update, an update after 1% of
+// the local matrices changed and an update after one subtree was reparented.
+
+static const int SCENEGRAPH_REPEATS = 100;
+
+template <typename F> static double timeMs(F prepare, mgl::SceneGraph &graph) {
+  double total = 0.0;
+  for (int r = 0; r < SCENEGRAPH_REPEATS; ++r) {
+    prepare(r);
+    const auto start = std::chrono::steady_clock::now();
+    graph.update();
+    const auto end = std::chrono::steady_clock::now();
+    total += std::chrono::duration<double, std::milli>(end - start).count();
+  }
+  return total / SCENEGRAPH_REPEATS;
+}
+
+static void printRow(const char *label, const size_t nodes, const double ms,
+                     const size_t updated) {
+  std::cout << std::left << std::setw(12) << label << std::right
+            << std::setw(8) << nodes << std::fixed << std::setprecision(3)
+            << std::setw(10) << ms << " ms" << std::setw(10) << updated
+            << " nodes updated" << std::endl;
+}
+
+static int runSceneGraph() {
+  const size_t counts[] = {10000, 100000};
+  for (const size_t n : counts) {
+    mgl::SceneGraph graph;
+    std::vector<mgl::SceneGraph::NodeId> nodes;
+    nodes.reserve(n);
+    nodes.push_back(graph.createNode());
+    for (size_t i = 1; i < n; ++i) {
+      nodes.push_back(graph.createNode(nodes[(i - 1) / 8]));
+    }
+    const glm::mat4 local =
+        glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, 0.0f, 0.0f));
+
+    const auto start = std::chrono::steady_clock::now();
+    graph.update();
+    const auto end = std::chrono::steady_clock::now();
+    printRow("full", n,
+             std::chrono::duration<double, std::milli>(end - start).count(),
+             graph.getUpdatedCount());
+
+    double ms = timeMs([](int) {}, graph);
+    printRow("idle", n, ms, graph.getUpdatedCount());
+
+    ms = timeMs(
+        [&](int r) {
+          for (size_t i = r; i < n; i += 100) {
+            graph.setLocalMatrix(nodes[i], local);
+          }
+        },
+        graph);
+    printRow("1% local", n, ms, graph.getUpdatedCount());
+
+    ms = timeMs(
+        [&](int r) {
+          graph.setParent(nodes[n - 1 - r], nodes[1 + r % 8]);
+        },
+        graph);
+    printRow("reparent", n, ms, graph.getUpdatedCount());
+  }
+  return EXIT_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////// RUN
+
+static int runEngine(mgl::App *app, int frames) {
+  mgl::Engine &engine = mgl::Engine::getInstance();
+  engine.setApp(app);
+  engine.setOpenGL(4, 6);
+  engine.setWindow(600, 600, "mgl benchmark", 0, 0);
+  engine.setHeadless(600, 600, frames);
+  engine.init();
+  engine.run();
+  return EXIT_SUCCESS;
+}
+
+int runBenchmark(const char *name) {
+  if (std::strcmp(name, "instancing") == 0) {
+    return runEngine(new InstancingBenchmark(),
+                     InstancingBenchmark::PHASES * PHASE_FRAMES);
+  }
+  if (std::strcmp(name, "vertexformat") == 0) {
+    return runEngine(new VertexFormatBenchmark(),
+                     VertexFormatBenchmark::PHASES * PHASE_FRAMES);
+  }
+  if (std::strcmp(name, "scenegraph") == 0) {
+    return runSceneGraph();
+  }
+  std::cerr << "Unknown benchmark: " << name
+            << " (expected instancing, vertexformat or scenegraph)"
+            << std::endl;
+  return EXIT_FAILURE;
+}
+
+//////////////////////////////////////////////////////////////////////////// END
@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Benchmarks
+//
+// Copyright (c) 2013-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+int runBenchmark(const char *name);
+
+#endif /* BENCHMARKS_HPP */
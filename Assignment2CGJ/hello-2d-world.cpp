@@ -18,9 +18,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "../mgl/mgl.hpp"
+#include "./benchmarks.hpp"
 
 ////////////////////////////////////////////////////////////////////////// MYAPP
 
@@ -36,9 +39,9 @@ public:
 
 private:
   const GLuint POSITION = 0, COLOR = 1;
-  GLuint VaoId, VboId[2];
+  mgl::MeshBuilder::Mesh Triangle;
   std::unique_ptr<mgl::ShaderProgram> Shaders = nullptr;
-  GLint MatrixId;
+  mgl::ShaderProgram::UniformHandle MatrixId;
 
   void createShaderProgram();
   void createBufferObjects();
@@ -55,11 +58,9 @@ void MyApp::createShaderProgram() {
 
   Shaders->addAttribute(mgl::POSITION_ATTRIBUTE, POSITION);
   Shaders->addAttribute(mgl::COLOR_ATTRIBUTE, COLOR);
-  Shaders->addUniform("Matrix");
+  MatrixId = Shaders->addUniform("Matrix");
 
   Shaders->create();
-
-  MatrixId = Shaders->Uniforms["Matrix"].index;
 }
 
 //////////////////////////////////////////////////////////////////// VAOs & VBOs
@@ -77,42 +78,25 @@ const Vertex Vertices[] = {
 const GLubyte Indices[] = {0, 1, 2};
 
 void MyApp::createBufferObjects() {
-  glGenVertexArrays(1, &VaoId);
-  glBindVertexArray(VaoId);
-  {
-    glGenBuffers(2, VboId);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VboId[0]);
-    {
-      glBufferData(GL_ARRAY_BUFFER, sizeof(Vertices), Vertices, GL_STATIC_DRAW);
-      glEnableVertexAttribArray(POSITION);
-      glVertexAttribPointer(POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                            reinterpret_cast<GLvoid *>(0));
-      glEnableVertexAttribArray(COLOR);
-      glVertexAttribPointer(
-          COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-          reinterpret_cast<GLvoid *>(sizeof(Vertices[0].XYZW)));
-    }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, VboId[1]);
-    {
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Indices), Indices,
-                   GL_STATIC_DRAW);
-    }
+  // Stored as half-float XYZ (W is fetched as 1) and normalized RGBA bytes:
+  // 12 bytes per vertex instead of 32.
+  mgl::VertexFormat format;
+  format.addPosition(POSITION).addColor(COLOR);
+  std::vector<GLubyte> packed(format.getStride() * 3);
+  for (size_t i = 0; i < 3; ++i) {
+    GLubyte *vertex = packed.data() + i * format.getStride();
+    format.pack(vertex, 0, glm::make_vec4(Vertices[i].XYZW));
+    format.pack(vertex, 1, glm::make_vec4(Vertices[i].RGBA));
   }
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-  glDeleteBuffers(2, VboId);
-}
 
-void MyApp::destroyBufferObjects() {
-  glBindVertexArray(VaoId);
-  glDisableVertexAttribArray(POSITION);
-  glDisableVertexAttribArray(COLOR);
-  glDeleteVertexArrays(1, &VaoId);
-  glBindVertexArray(0);
+  Triangle = mgl::MeshBuilder(format)
+                 .setVertices(packed.data(), 3)
+                 .setIndices(Indices, 3, GL_UNSIGNED_BYTE)
+                 .build();
 }
 
+void MyApp::destroyBufferObjects() { mgl::MeshBuilder::destroy(Triangle); }
+
 ////////////////////////////////////////////////////////////////////////// SCENE
 
 const glm::mat4 I(1.0f);
@@ -120,21 +104,22 @@ const glm::mat4 M =
     glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f, -1.0f, 0.0f));
 
 void MyApp::drawScene() {
-  // Drawing directly in clip space
+  // Drawing directly in clip space; bindings are left in place so that the
+  // state cache can skip them on the next frame. Both triangles share the
+  // Matrix uniform, so each setMat4 below is a real upload: the shadow copy
+  // only elides values repeated between consecutive sets of a uniform.
 
-  glBindVertexArray(VaoId);
+  mgl::StateCache::getInstance().bindVertexArray(
+      mgl::Resources::getInstance().get(Triangle.vao));
   Shaders->bind();
 
-  glUniformMatrix4fv(MatrixId, 1, GL_FALSE, glm::value_ptr(I));
-  glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_BYTE,
+  Shaders->setMat4(MatrixId, I);
+  glDrawElements(GL_TRIANGLES, Triangle.index_count, Triangle.index_type,
                  reinterpret_cast<GLvoid *>(0));
 
-  glUniformMatrix4fv(MatrixId, 1, GL_FALSE, glm::value_ptr(M));
-  glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_BYTE,
+  Shaders->setMat4(MatrixId, M);
+  glDrawElements(GL_TRIANGLES, Triangle.index_count, Triangle.index_type,
                  reinterpret_cast<GLvoid *>(0));
-
-  Shaders->unbind();
-  glBindVertexArray(0);
 }
 
 ////////////////////////////////////////////////////////////////////// CALLBACKS
@@ -155,10 +140,16 @@ void MyApp::displayCallback(GLFWwindow *win, double elapsed) { drawScene(); }
 /////////////////////////////////////////////////////////////////////////// MAIN
 
 int main(int argc, char *argv[]) {
+  if (argc > 2 && std::strcmp(argv[1], "--bench") == 0) {
+    exit(runBenchmark(argv[2]));
+  }
   mgl::Engine &engine = mgl::Engine::getInstance();
   engine.setApp(new MyApp());
   engine.setOpenGL(4, 6);
   engine.setWindow(600, 600, "Hello Modern 2D World", 0, 1);
+  if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+    engine.setHeadless(600, 600, 1000);
+  }
   engine.init();
   engine.run();
   exit(EXIT_SUCCESS);
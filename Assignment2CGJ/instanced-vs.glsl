@@ -0,0 +1,13 @@
+#version 330 core
+
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in mat4 inInstanceMatrix;
+layout(location = 6) in vec4 inInstanceColor;
+
+out vec4 exColor;
+
+void main(void) {
+    gl_Position = inInstanceMatrix * inPosition;
+    exColor = inColor * inInstanceColor;
+}
@@ -12,9 +12,27 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
-#include "./mglApp.hpp"         // IWYU pragma: keep
-#include "./mglConventions.hpp" // IWYU pragma: keep
-#include "./mglError.hpp"       // IWYU pragma: keep
-#include "./mglShader.hpp"      // IWYU pragma: keep
+#include "./mglApp.hpp"          // IWYU pragma: keep
+#include "./mglArena.hpp"        // IWYU pragma: keep
+#include "./mglBufferHeap.hpp"   // IWYU pragma: keep
+#include "./mglCamera.hpp"       // IWYU pragma: keep
+#include "./mglCommandList.hpp"  // IWYU pragma: keep
+#include "./mglConventions.hpp"  // IWYU pragma: keep
+#include "./mglError.hpp"        // IWYU pragma: keep
+#include "./mglInstancing.hpp"   // IWYU pragma: keep
+#include "./mglJobs.hpp"         // IWYU pragma: keep
+#include "./mglLayout.hpp"       // IWYU pragma: keep
+#include "./mglMeshBuffer.hpp"   // IWYU pragma: keep
+#include "./mglMeshBuilder.hpp"  // IWYU pragma: keep
+#include "./mglMeshOptimizer.hpp" // IWYU pragma: keep
+#include "./mglProfiler.hpp"     // IWYU pragma: keep
+#include "./mglRenderQueue.hpp"  // IWYU pragma: keep
+#include "./mglResources.hpp"    // IWYU pragma: keep
+#include "./mglScenegraph.hpp"   // IWYU pragma: keep
+#include "./mglShader.hpp"       // IWYU pragma: keep
+#include "./mglState.hpp"        // IWYU pragma: keep
+#include "./mglStreamBuffer.hpp" // IWYU pragma: keep
+#include "./mglTransforms.hpp"   // IWYU pragma: keep
+#include "./mglVertexFormat.hpp" // IWYU pragma: keep
 
 #endif /* MGL_HPP */
@@ -9,17 +9,25 @@
 #include "./mglApp.hpp"
 
 #include <GLFW/glfw3.h>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
 #include "./mglError.hpp" // IWYU pragma: keep -- required in debug mode
+#include "./mglResources.hpp"
+#include "./mglShader.hpp"
+#include "./mglState.hpp"
 
 namespace mgl {
 
 /////////////////////////////////////////////////////////////// STATIC CALLBACKS
 
 static void window_close_callback(GLFWwindow *window) {
-  Engine::getInstance().getApp()->windowCloseCallback(window);
+  Engine &engine = Engine::getInstance();
+  if (!engine.isRenderThreaded()) {
+    engine.getApp()->windowCloseCallback(window);
+  }
 }
 
 static void window_size_callback(GLFWwindow *window, int width, int height) {
@@ -60,7 +68,19 @@ static void joystick_callback(int jid, int event) {
 Engine::Engine(void)
     : WindowWidth(640), WindowHeight(480), GlApp(nullptr), Window(nullptr),
       WindowTitle("OpenGL App GLFW Window 2025(c) Carlos Martinho"), GlMajor(3),
-      GlMinor(3), Fullscreen(0), Vsync(0) {}
+      GlMinor(3), Fullscreen(0), Vsync(0), Headless(0), HeadlessFrames(0),
+      ContextApi(GLFW_NATIVE_CONTEXT_API), FramebufferId(0),
+      RenderbufferId{0, 0}, FixedStep(0.0), MaxSteps(0), RenderThreaded(0),
+      RenderRunning(false), Submitted(-1), Executing(-1), Recording(0) {
+  UpdateZone = FrameProfiler.registerZone("Update");
+  DisplayZone = FrameProfiler.registerZone("Display");
+  SwapZone = FrameProfiler.registerZone("SwapBuffers");
+  PollZone = FrameProfiler.registerZone("PollEvents");
+  WaitZone = FrameProfiler.registerZone("WaitRender");
+  RecordZone = FrameProfiler.registerZone("Record");
+  ExecuteZone = RenderProfiler.registerZone("Execute");
+  RenderSwapZone = RenderProfiler.registerZone("SwapBuffers");
+}
 
 Engine::~Engine(void) {}
 
@@ -87,9 +107,83 @@ void Engine::setWindow(int width, int height, const char *title, int fullscreen,
   Vsync = vsync;
 }
 
+// Renders into an offscreen framebuffer without a display server. GLFW runs
+// on its null platform and the context comes from EGL (surfaceless) or OSMesa,
+// so Mesa llvmpipe is enough. A frame count of 0 runs until the App requests
+// the window to close.
+void Engine::setHeadless(int width, int height, int frames, int context_api) {
+  WindowWidth = width;
+  WindowHeight = height;
+  Headless = 1;
+  HeadlessFrames = frames;
+  ContextApi = context_api;
+  Fullscreen = 0;
+  Vsync = 0;
+}
+
+bool Engine::isHeadless() { return Headless != 0; }
+
+// Simulation advances through App::updateCallback in steps of exactly 'step'
+// seconds, independently of the frame rate. At most 'max_steps' updates run per
+// frame; any backlog beyond that is dropped instead of being caught up. The
+// leftover fraction of a step is passed to displayCallback as 'alpha' so the
+// App can interpolate between the last two simulation states. A step of 0
+// restores the variable timestep.
+void Engine::setFixedTimestep(double step, int max_steps) {
+  FixedStep = step;
+  MaxSteps = max_steps > 0 ? max_steps : 1;
+}
+
+// Splits every frame across two threads: the main thread polls events, runs
+// the simulation and records frame N+1 through App::recordCallback while a
+// render thread, which owns the GL context, replays frame N and swaps. The
+// two command lists alternate between them. In this mode only the render
+// thread may touch GL: other App callbacks run without a context and must
+// record their GL work into getCommandList(). windowCloseCallback is deferred
+// until the render thread has stopped and the context is back on the main
+// thread. GPU timings then come from getRenderProfiler().
+void Engine::setRenderThread(int enabled) { RenderThreaded = enabled; }
+
+bool Engine::isRenderThreaded() { return RenderThreaded != 0; }
+
+CommandList &Engine::getCommandList() { return Lists[Recording]; }
+
+// Transient memory for the frame being recorded. There are two arenas, one
+// per command list, so anything a frame allocates stays valid until the
+// frame after it has been recorded (and, when render threaded, replayed).
+// The arena is reset when its frame slot is reused; must be sized before
+// run().
+void Engine::setFrameArenaSize(size_t bytes) {
+  FrameArenas[0].setCapacity(bytes);
+  FrameArenas[1].setCapacity(bytes);
+}
+
+LinearArena &Engine::getFrameArena() { return FrameArenas[Recording]; }
+
+Profiler &Engine::getProfiler() { return FrameProfiler; }
+
+// When render threaded, the main thread has no context and its profiler
+// only times CPU zones; the render thread times the replay of each command
+// list (GPU included) and the buffer swap with this one, which is enabled
+// along with getProfiler() when run() starts. Read it only after run().
+Profiler &Engine::getRenderProfiler() { return RenderProfiler; }
+
+JobSystem &Engine::getJobSystem() { return Jobs; }
+
+void Engine::readPixels(std::vector<GLubyte> &pixels) {
+  pixels.resize(static_cast<size_t>(WindowWidth) * WindowHeight * 4);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, WindowWidth, WindowHeight, GL_RGBA, GL_UNSIGNED_BYTE,
+               pixels.data());
+}
+
 /////////////////////////////////////////////////////////////////////////// INIT
 
 void Engine::setupWindow() {
+  if (Headless) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, ContextApi);
+  }
   GLFWmonitor *monitor = Fullscreen ? glfwGetPrimaryMonitor() : nullptr;
   Window = glfwCreateWindow(WindowWidth, WindowHeight, WindowTitle, monitor,
                             nullptr);
@@ -112,6 +206,9 @@ void Engine::setupCallbacks() {
 
 void Engine::setupGLFW() {
   glfwSetErrorCallback(glfw_error_callback);
+  if (Headless) {
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+  }
   if (!glfwInit()) {
     throw std::runtime_error("Failed to initialize GLFW.");
   }
@@ -137,17 +234,52 @@ void Engine::setupGLEW() {
   }
 }
 
+void Engine::setupFramebuffer() {
+  glGenRenderbuffers(2, RenderbufferId);
+  glBindRenderbuffer(GL_RENDERBUFFER, RenderbufferId[0]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WindowWidth, WindowHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, RenderbufferId[1]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, WindowWidth,
+                        WindowHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &FramebufferId);
+  glBindFramebuffer(GL_FRAMEBUFFER, FramebufferId);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, RenderbufferId[0]);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, RenderbufferId[1]);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    throw std::runtime_error("Failed to create headless framebuffer.");
+  }
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+void Engine::destroyFramebuffer() {
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteFramebuffers(1, &FramebufferId);
+  glDeleteRenderbuffers(2, RenderbufferId);
+  FramebufferId = 0;
+}
+
 void Engine::setupOpenGL() {
+  StateCache &state = StateCache::getInstance();
+  state.invalidate();
   glClearColor(0.1f, 0.1f, 0.3f, 1.0f);
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LEQUAL);
-  glDepthMask(GL_TRUE);
+  state.enable(GL_DEPTH_TEST);
+  state.depthFunc(GL_LEQUAL);
+  state.depthMask(GL_TRUE);
   glDepthRange(0.0, 1.0);
   glClearDepth(1.0);
-  glEnable(GL_CULL_FACE);
-  glCullFace(GL_BACK);
-  glFrontFace(GL_CCW);
+  state.enable(GL_CULL_FACE);
+  state.cullFace(GL_BACK);
+  state.frontFace(GL_CCW);
   glViewport(0, 0, WindowWidth, WindowHeight);
+  if (GLEW_KHR_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  } else if (GLEW_ARB_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+  }
 }
 
 void displayInfo() {
@@ -164,7 +296,12 @@ void displayInfo() {
 void Engine::init() {
   setupGLFW();
   setupGLEW();
+  if (Headless) {
+    setupFramebuffer();
+  }
   setupOpenGL();
+  FrameProfiler.init();
+  Jobs.start();
   GlApp->initCallback(Window);
 #ifdef DEBUG
   displayInfo();
@@ -174,23 +311,186 @@ void Engine::init() {
 
 //////////////////////////////////////////////////////////////////////////// RUN
 
-void Engine::run() {
+double Engine::update(double elapsed, double &accumulator) {
+  if (FixedStep <= 0.0) {
+    return 1.0;
+  }
+  ProfileZone zone(FrameProfiler, UpdateZone);
+  accumulator += elapsed;
+  int steps = 0;
+  while (accumulator >= FixedStep && steps < MaxSteps) {
+    GlApp->updateCallback(Window, FixedStep);
+    accumulator -= FixedStep;
+    ++steps;
+  }
+  accumulator = std::fmod(accumulator, FixedStep);
+  return accumulator / FixedStep;
+}
+
+void Engine::runSerial() {
   double last_time = glfwGetTime();
+  double accumulator = 0.0;
+  int frame = 0;
   while (!glfwWindowShouldClose(Window)) {
     try {
+      if (Headless && HeadlessFrames > 0 && frame++ >= HeadlessFrames) {
+        GlApp->windowCloseCallback(Window);
+        glfwSetWindowShouldClose(Window, GLFW_TRUE);
+        break;
+      }
       double time = glfwGetTime();
       double elapsed_time = time - last_time;
       last_time = time;
-      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
-              GL_STENCIL_BUFFER_BIT);
-      GlApp->displayCallback(Window, elapsed_time);
-      glfwSwapBuffers(Window);
-      glfwPollEvents();
+      FrameProfiler.beginFrame();
+      double alpha = update(elapsed_time, accumulator);
+      {
+        ProfileZone zone(FrameProfiler, DisplayZone, true);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
+                GL_STENCIL_BUFFER_BIT);
+        GlApp->displayCallback(Window, elapsed_time, alpha);
+      }
+      if (!Headless) {
+        ProfileZone zone(FrameProfiler, SwapZone);
+        glfwSwapBuffers(Window);
+      }
+      {
+        ProfileZone zone(FrameProfiler, PollZone);
+        glfwPollEvents();
+      }
+      ShaderProgram::newFrame();
+      StateCache::getInstance().newFrame();
+      Resources::getInstance().newFrame();
+      Recording ^= 1;
+      FrameArenas[Recording].reset();
+      FrameProfiler.endFrame();
     } catch (const std::exception &e) {
       std::cerr << "FRAME EXCEPTION: " << e.what() << std::endl;
       glfwSetWindowShouldClose(Window, GLFW_TRUE);
     }
   }
+}
+
+void Engine::renderLoop() {
+  glfwMakeContextCurrent(Window);
+  RenderProfiler.init();
+  std::unique_lock<std::mutex> lock(RenderMutex);
+  while (true) {
+    RenderSignal.wait(lock,
+                      [this] { return Submitted >= 0 || !RenderRunning; });
+    if (Submitted < 0) {
+      break;
+    }
+    Executing = Submitted;
+    Submitted = -1;
+    lock.unlock();
+    RenderSignal.notify_all();
+    try {
+      RenderProfiler.beginFrame();
+      {
+        ProfileZone zone(RenderProfiler, ExecuteZone, true);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
+                GL_STENCIL_BUFFER_BIT);
+        Lists[Executing].execute();
+      }
+      if (!Headless) {
+        ProfileZone zone(RenderProfiler, RenderSwapZone);
+        glfwSwapBuffers(Window);
+      }
+      ShaderProgram::newFrame();
+      StateCache::getInstance().newFrame();
+      Resources::getInstance().newFrame();
+      RenderProfiler.endFrame();
+    } catch (const std::exception &e) {
+      std::cerr << "RENDER EXCEPTION: " << e.what() << std::endl;
+      glfwSetWindowShouldClose(Window, GLFW_TRUE);
+    }
+    lock.lock();
+    Executing = -1;
+    RenderSignal.notify_all();
+  }
+  RenderProfiler.destroy();
+  glfwMakeContextCurrent(nullptr);
+}
+
+void Engine::runPipelined() {
+  // Release the main thread's queries while it still has the context; its
+  // GPU zones degrade to CPU-only zones from here on.
+  FrameProfiler.destroy();
+  RenderProfiler.setEnabled(FrameProfiler.isEnabled());
+  Resources::getInstance().setLatency(1);
+  glfwMakeContextCurrent(nullptr);
+  Submitted = Executing = -1;
+  RenderRunning = true;
+  std::thread render(&Engine::renderLoop, this);
+
+  double last_time = glfwGetTime();
+  double accumulator = 0.0;
+  int frame = 0;
+  while (!glfwWindowShouldClose(Window)) {
+    try {
+      if (Headless && HeadlessFrames > 0 && frame++ >= HeadlessFrames) {
+        glfwSetWindowShouldClose(Window, GLFW_TRUE);
+        break;
+      }
+      FrameProfiler.beginFrame();
+      {
+        ProfileZone zone(FrameProfiler, WaitZone);
+        std::unique_lock<std::mutex> lock(RenderMutex);
+        RenderSignal.wait(lock, [this] {
+          return Executing != Recording && Submitted != Recording;
+        });
+      }
+      Lists[Recording].clear();
+      FrameArenas[Recording].reset();
+      {
+        ProfileZone zone(FrameProfiler, PollZone);
+        glfwPollEvents();
+      }
+      double time = glfwGetTime();
+      double elapsed_time = time - last_time;
+      last_time = time;
+      double alpha = update(elapsed_time, accumulator);
+      {
+        ProfileZone zone(FrameProfiler, RecordZone);
+        GlApp->recordCallback(Window, elapsed_time, alpha, Lists[Recording]);
+      }
+      {
+        std::unique_lock<std::mutex> lock(RenderMutex);
+        RenderSignal.wait(lock, [this] { return Submitted < 0; });
+        Submitted = Recording;
+      }
+      RenderSignal.notify_all();
+      Recording ^= 1;
+      FrameProfiler.endFrame();
+    } catch (const std::exception &e) {
+      std::cerr << "FRAME EXCEPTION: " << e.what() << std::endl;
+      glfwSetWindowShouldClose(Window, GLFW_TRUE);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(RenderMutex);
+    RenderRunning = false;
+  }
+  RenderSignal.notify_all();
+  render.join();
+  Resources::getInstance().setLatency(0);
+  glfwMakeContextCurrent(Window);
+  GlApp->windowCloseCallback(Window);
+}
+
+void Engine::run() {
+  if (RenderThreaded) {
+    runPipelined();
+  } else {
+    runSerial();
+  }
+  Jobs.stop();
+  Resources::getInstance().flush();
+  FrameProfiler.destroy();
+  if (FramebufferId) {
+    destroyFramebuffer();
+  }
   glfwDestroyWindow(Window);
   Window = nullptr;
   glfwTerminate();
@@ -12,7 +12,15 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/ext.hpp>
+#include <condition_variable>
 #include <glm/glm.hpp>
+#include <mutex>
+#include <vector>
+
+#include "./mglArena.hpp"
+#include "./mglCommandList.hpp"
+#include "./mglJobs.hpp"
+#include "./mglProfiler.hpp"
 
 namespace mgl {
 
@@ -24,7 +32,14 @@ class Engine;
 class App {
 public:
   virtual void initCallback(GLFWwindow *window) {}
+  virtual void updateCallback(GLFWwindow *window, double dt) {}
   virtual void displayCallback(GLFWwindow *window, double elapsed) {}
+  virtual void displayCallback(GLFWwindow *window, double elapsed,
+                               double alpha) {
+    displayCallback(window, elapsed);
+  }
+  virtual void recordCallback(GLFWwindow *window, double elapsed,
+                              double alpha, CommandList &commands) {}
   virtual void windowCloseCallback(GLFWwindow *window) {}
   virtual void windowSizeCallback(GLFWwindow *window, int width, int height) {}
   virtual void cursorCallback(GLFWwindow *window, double xpos, double ypos) {}
@@ -53,6 +68,19 @@ public:
   void setOpenGL(int major, int minor);
   void setWindow(int width, int height, const char *title, int fullscreen,
                  int vsync);
+  void setHeadless(int width, int height, int frames,
+                   int context_api = GLFW_EGL_CONTEXT_API);
+  bool isHeadless();
+  void setFixedTimestep(double step, int max_steps);
+  void setRenderThread(int enabled);
+  bool isRenderThreaded();
+  CommandList &getCommandList();
+  void setFrameArenaSize(size_t bytes);
+  LinearArena &getFrameArena();
+  void readPixels(std::vector<GLubyte> &pixels);
+  Profiler &getProfiler();
+  Profiler &getRenderProfiler();
+  JobSystem &getJobSystem();
   void init();
   void run();
 
@@ -67,12 +95,38 @@ private:
   int GlMajor, GlMinor;
   int Fullscreen;
   int Vsync;
+  int Headless;
+  int HeadlessFrames;
+  int ContextApi;
+  GLuint FramebufferId;
+  GLuint RenderbufferId[2];
+  double FixedStep;
+  int MaxSteps;
+  Profiler FrameProfiler;
+  Profiler::ZoneId UpdateZone, DisplayZone, SwapZone, PollZone, WaitZone,
+      RecordZone;
+  Profiler RenderProfiler;
+  Profiler::ZoneId ExecuteZone, RenderSwapZone;
+  JobSystem Jobs;
+  int RenderThreaded;
+  bool RenderRunning;
+  int Submitted, Executing, Recording;
+  CommandList Lists[2];
+  LinearArena FrameArenas[2];
+  std::mutex RenderMutex;
+  std::condition_variable RenderSignal;
 
   void setupWindow();
+  void setupFramebuffer();
+  void destroyFramebuffer();
   void setupGLFW();
   void setupGLEW();
   void setupOpenGL();
   void setupCallbacks();
+  double update(double elapsed, double &accumulator);
+  void runSerial();
+  void runPipelined();
+  void renderLoop();
 
 public:
   Engine(Engine const &) = delete;
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Linear Arena Allocator
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace mgl {
+
+//////////////////////////////////////////////////////////////////// LinearArena
+
+// A bump allocator over one contiguous block, reserved on first use.
+// Allocation is a pointer increment and memory is only ever released all at
+// once by reset(); deallocation through ArenaAllocator is a no-op, so
+// containers built on it must not outlive the next reset. Requests that do
+// not fit spill into individually allocated overflow blocks, and the next
+// reset() grows the main block to at least the peak seen so far, so the arena
+// settles after a few frames. Not thread safe: each thread needs its own
+// arena.
+
+const size_t LinearArena::DEFAULT_CAPACITY;
+
+LinearArena::LinearArena(const size_t capacity)
+    : Capacity(capacity), Head(0), Used(0), Peak(0), Overflows(0) {}
+
+LinearArena::~LinearArena() {}
+
+void LinearArena::setCapacity(const size_t capacity) {
+  Block.reset();
+  Overflow.clear();
+  Capacity = capacity;
+  Head = Used = 0;
+}
+
+void *LinearArena::allocate(const size_t size, const size_t alignment) {
+  if (!Block) {
+    Block.reset(new unsigned char[Capacity]);
+  }
+  const uintptr_t base = reinterpret_cast<uintptr_t>(Block.get());
+  const uintptr_t aligned = (base + Head + alignment - 1) & ~(alignment - 1);
+  const size_t offset = static_cast<size_t>(aligned - base);
+  void *p;
+  if (offset + size <= Capacity) {
+    Used += offset + size - Head;
+    Head = offset + size;
+    p = Block.get() + offset;
+  } else {
+    Overflows++;
+    Overflow.emplace_back(new unsigned char[size + alignment]);
+    const uintptr_t block = reinterpret_cast<uintptr_t>(Overflow.back().get());
+    p = reinterpret_cast<void *>((block + alignment - 1) & ~(alignment - 1));
+    Used += size + alignment;
+  }
+  Peak = std::max(Peak, Used);
+  return p;
+}
+
+void LinearArena::reset() {
+  if (!Overflow.empty()) {
+    Overflow.clear();
+    Capacity = std::max(Capacity * 2, Peak);
+    Block.reset();
+  }
+  Head = Used = 0;
+}
+
+LinearArena::Stats LinearArena::getStats() {
+  return {Used, Peak, Capacity, Overflows};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
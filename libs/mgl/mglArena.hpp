@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Linear Arena Allocator
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_ARENA_HPP
+#define MGL_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace mgl {
+
+class LinearArena;
+template <typename T> class ArenaAllocator;
+
+//////////////////////////////////////////////////////////////////// LinearArena
+
+class LinearArena final {
+public:
+  static const size_t DEFAULT_CAPACITY = 1024 * 1024;
+
+  struct Stats {
+    size_t used;
+    size_t peak;
+    size_t capacity;
+    unsigned overflows;
+  };
+
+  explicit LinearArena(const size_t capacity = DEFAULT_CAPACITY);
+  ~LinearArena();
+
+  LinearArena(const LinearArena &) = delete;
+  LinearArena &operator=(const LinearArena &) = delete;
+
+  void setCapacity(const size_t capacity);
+  void *allocate(const size_t size,
+                 const size_t alignment = alignof(std::max_align_t));
+  template <typename T> T *allocate(const size_t count = 1);
+  void reset();
+  Stats getStats();
+
+private:
+  std::unique_ptr<unsigned char[]> Block;
+  std::vector<std::unique_ptr<unsigned char[]>> Overflow;
+  size_t Capacity;
+  size_t Head;
+  size_t Used;
+  size_t Peak;
+  unsigned Overflows;
+};
+
+template <typename T> T *LinearArena::allocate(const size_t count) {
+  return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+}
+
+///////////////////////////////////////////////////////////////// ArenaAllocator
+
+template <typename T> class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  ArenaAllocator(LinearArena &arena) noexcept : Arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+      : Arena(other.Arena) {}
+
+  T *allocate(const size_t n) { return Arena->allocate<T>(n); }
+  void deallocate(T *p, const size_t n) noexcept {}
+
+private:
+  LinearArena *Arena;
+
+  template <typename U> friend class ArenaAllocator;
+  template <typename U, typename V>
+  friend bool operator==(const ArenaAllocator<U> &a,
+                         const ArenaAllocator<V> &b) noexcept;
+};
+
+template <typename U, typename V>
+bool operator==(const ArenaAllocator<U> &a,
+                const ArenaAllocator<V> &b) noexcept {
+  return a.Arena == b.Arena;
+}
+
+template <typename U, typename V>
+bool operator!=(const ArenaAllocator<U> &a,
+                const ArenaAllocator<V> &b) noexcept {
+  return !(a == b);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_ARENA_HPP */
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Sub-allocating GPU Buffer Heap
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglBufferHeap.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////// BufferHeap
+
+// Reserves large immutable buffers (pages) and carves vertex and index ranges
+// out of them with a binary buddy allocator, so many small meshes share a few
+// buffer objects. Every block is MinBlock << order bytes and aligned to its
+// own size; a freed block merges with its buddy whenever the buddy is free
+// too. A request larger than the page size gets a page of its own.
+//
+// Allocations are referred to by id and may move during defragment(), which
+// empties the least occupied pages by copying their blocks into the others
+// with glCopyBufferSubData and then releases them. Ranges must therefore be
+// re-read with getRange() after a defragmentation. Pages are buffers from the
+// Resources pool, so a released page is only deleted once the GPU is done
+// with it; the destructor releases every page. Direct state access is used
+// when available, so neither uploads nor moves disturb the buffer bindings.
+
+const GLsizeiptr BufferHeap::DEFAULT_PAGE_SIZE;
+const GLsizeiptr BufferHeap::DEFAULT_MIN_BLOCK;
+
+static const GLuint NO_PAGE = 0xFFFFFFFF;
+
+BufferHeap::BufferHeap(const GLsizeiptr page_size, const GLsizeiptr min_block)
+    : PageSize(min_block), MinBlock(min_block), Moved(0) {
+  while (PageSize < page_size) {
+    PageSize *= 2;
+  }
+}
+
+BufferHeap::~BufferHeap() { destroy(); }
+
+int BufferHeap::orderOf(const GLsizeiptr size) const {
+  int order = 0;
+  while ((MinBlock << order) < size) {
+    ++order;
+  }
+  return order;
+}
+
+int BufferHeap::createPage(const int order) {
+  const GLsizeiptr size = std::max(PageSize, MinBlock << order);
+  int index = static_cast<int>(Pages.size());
+  for (int i = 0; i < index; ++i) {
+    if (Pages[i].buffer == NO_PAGE) {
+      index = i;
+      break;
+    }
+  }
+  if (index == static_cast<int>(Pages.size())) {
+    Pages.push_back(Page());
+  }
+  Page &page = Pages[index];
+  page.handle = Resources::getInstance().createBuffer();
+  page.buffer = Resources::getInstance().get(page.handle);
+  page.size = size;
+  page.used = 0;
+  page.Free.assign(orderOf(size) + 1, std::set<GLintptr>());
+  page.Free.back().insert(0);
+
+  if (StateCache::hasDirectStateAccess()) {
+    glNamedBufferStorage(page.buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    return index;
+  }
+  StateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+  if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+    glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr,
+                    GL_DYNAMIC_STORAGE_BIT);
+  } else {
+    glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+  }
+  return index;
+}
+
+void BufferHeap::releasePage(const int index) {
+  Page &page = Pages[index];
+  Resources::getInstance().destroy(page.handle);
+  page.handle = BufferHandle();
+  page.buffer = NO_PAGE;
+  page.Free.clear();
+}
+
+GLintptr BufferHeap::allocateBlock(Page &page, const int order) {
+  const int orders = static_cast<int>(page.Free.size());
+  int k = order;
+  while (k < orders && page.Free[k].empty()) {
+    ++k;
+  }
+  if (k >= orders) {
+    return -1;
+  }
+  const GLintptr offset = *page.Free[k].begin();
+  page.Free[k].erase(page.Free[k].begin());
+  while (k > order) {
+    --k;
+    page.Free[k].insert(offset + (MinBlock << k));
+  }
+  page.used += MinBlock << order;
+  return offset;
+}
+
+void BufferHeap::freeBlock(Page &page, GLintptr offset, int order) {
+  page.used -= MinBlock << order;
+  const int orders = static_cast<int>(page.Free.size());
+  while (order < orders - 1) {
+    const GLintptr buddy = offset ^ (MinBlock << order);
+    auto it = page.Free[order].find(buddy);
+    if (it == page.Free[order].end()) {
+      break;
+    }
+    page.Free[order].erase(it);
+    offset = std::min(offset, buddy);
+    ++order;
+  }
+  page.Free[order].insert(offset);
+}
+
+bool BufferHeap::place(const int order, const int exclude, int &page,
+                       GLintptr &offset) {
+  for (int i = 0; i < static_cast<int>(Pages.size()); ++i) {
+    if (i == exclude || Pages[i].buffer == NO_PAGE) {
+      continue;
+    }
+    offset = allocateBlock(Pages[i], order);
+    if (offset >= 0) {
+      page = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+BufferHeap::AllocationId BufferHeap::allocate(const GLsizeiptr size,
+                                              const void *data) {
+  const int order = orderOf(size);
+  int page;
+  GLintptr offset;
+  if (!place(order, -1, page, offset)) {
+    page = createPage(order);
+    offset = allocateBlock(Pages[page], order);
+  }
+  AllocationId id;
+  if (FreeIds.empty()) {
+    id = static_cast<AllocationId>(Allocations.size());
+    Allocations.push_back({page, offset, size, order});
+  } else {
+    id = FreeIds.back();
+    FreeIds.pop_back();
+    Allocations[id] = {page, offset, size, order};
+  }
+  if (data) {
+    upload(id, data, size);
+  }
+  return id;
+}
+
+const BufferHeap::Allocation &
+BufferHeap::lookup(const AllocationId id) const {
+  if (id >= Allocations.size() || Allocations[id].page < 0) {
+    std::cerr << "Invalid buffer heap allocation " << id << "." << std::endl;
+    throw std::runtime_error("Invalid buffer heap allocation.");
+  }
+  return Allocations[id];
+}
+
+void BufferHeap::upload(const AllocationId id, const void *data,
+                        const GLsizeiptr size, const GLintptr offset) {
+  const Allocation &a = lookup(id);
+  if (offset + size > a.size) {
+    throw std::runtime_error("Upload exceeds buffer heap allocation.");
+  }
+  if (StateCache::hasDirectStateAccess()) {
+    glNamedBufferSubData(Pages[a.page].buffer, a.offset + offset, size, data);
+    return;
+  }
+  StateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER,
+                                       Pages[a.page].buffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, a.offset + offset, size, data);
+}
+
+void BufferHeap::free(const AllocationId id) {
+  lookup(id);
+  Allocation &a = Allocations[id];
+  freeBlock(Pages[a.page], a.offset, a.order);
+  a.page = -1;
+  FreeIds.push_back(id);
+}
+
+BufferHeap::Range BufferHeap::getRange(const AllocationId id) const {
+  const Allocation &a = lookup(id);
+  return {Pages[a.page].buffer, a.offset, a.size};
+}
+
+GLsizeiptr BufferHeap::defragment(const GLsizeiptr max_bytes) {
+  StateCache &state = StateCache::getInstance();
+  const bool dsa = StateCache::hasDirectStateAccess();
+  GLsizeiptr moved = 0;
+  while (moved < max_bytes) {
+    int source = -1;
+    for (int i = 0; i < static_cast<int>(Pages.size()); ++i) {
+      const Page &p = Pages[i];
+      if (p.buffer != NO_PAGE && p.used * 2 <= p.size &&
+          (source < 0 || p.used < Pages[source].used)) {
+        source = i;
+      }
+    }
+    if (source < 0) {
+      break;
+    }
+    bool emptied = true;
+    for (Allocation &a : Allocations) {
+      if (a.page != source) {
+        continue;
+      }
+      int page;
+      GLintptr offset;
+      if (moved >= max_bytes || !place(a.order, source, page, offset)) {
+        emptied = false;
+        break;
+      }
+      if (dsa) {
+        glCopyNamedBufferSubData(Pages[source].buffer, Pages[page].buffer,
+                                 a.offset, offset, a.size);
+      } else {
+        state.bindBuffer(GL_COPY_READ_BUFFER, Pages[source].buffer);
+        state.bindBuffer(GL_COPY_WRITE_BUFFER, Pages[page].buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            a.offset, offset, a.size);
+      }
+      freeBlock(Pages[source], a.offset, a.order);
+      a.page = page;
+      a.offset = offset;
+      moved += a.size;
+    }
+    if (!emptied) {
+      break;
+    }
+    releasePage(source);
+  }
+  Moved += moved;
+  return moved;
+}
+
+void BufferHeap::destroy() {
+  for (int i = 0; i < static_cast<int>(Pages.size()); ++i) {
+    if (Pages[i].buffer != NO_PAGE) {
+      releasePage(i);
+    }
+  }
+  Pages.clear();
+  Allocations.clear();
+  FreeIds.clear();
+}
+
+BufferHeap::Stats BufferHeap::getStats() {
+  Stats stats = {0, 0, 0, 0, Moved};
+  for (const Page &p : Pages) {
+    if (p.buffer != NO_PAGE) {
+      stats.pages++;
+      stats.allocated += p.used;
+      stats.reserved += p.size;
+    }
+  }
+  stats.allocations =
+      static_cast<unsigned>(Allocations.size() - FreeIds.size());
+  return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Sub-allocating GPU Buffer Heap
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_BUFFER_HEAP_HPP
+#define MGL_BUFFER_HEAP_HPP
+
+#include <GL/glew.h>
+
+#include <set>
+#include <vector>
+
+#include "./mglResources.hpp"
+
+namespace mgl {
+
+class BufferHeap;
+
+///////////////////////////////////////////////////////////////////// BufferHeap
+
+class BufferHeap final {
+public:
+  static const GLsizeiptr DEFAULT_PAGE_SIZE = 32 * 1024 * 1024;
+  static const GLsizeiptr DEFAULT_MIN_BLOCK = 256;
+
+  typedef GLuint AllocationId;
+
+  struct Range {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  struct Stats {
+    unsigned pages;
+    unsigned allocations;
+    GLsizeiptr allocated;
+    GLsizeiptr reserved;
+    GLsizeiptr moved;
+  };
+
+  explicit BufferHeap(const GLsizeiptr page_size = DEFAULT_PAGE_SIZE,
+                      const GLsizeiptr min_block = DEFAULT_MIN_BLOCK);
+  ~BufferHeap();
+
+  BufferHeap(const BufferHeap &) = delete;
+  BufferHeap &operator=(const BufferHeap &) = delete;
+
+  AllocationId allocate(const GLsizeiptr size, const void *data = nullptr);
+  void upload(const AllocationId id, const void *data, const GLsizeiptr size,
+              const GLintptr offset = 0);
+  void free(const AllocationId id);
+  Range getRange(const AllocationId id) const;
+  GLsizeiptr defragment(const GLsizeiptr max_bytes);
+  void destroy();
+  Stats getStats();
+
+private:
+  struct Page {
+    BufferHandle handle;
+    GLuint buffer;
+    GLsizeiptr size;
+    GLsizeiptr used;
+    std::vector<std::set<GLintptr>> Free;
+  };
+
+  struct Allocation {
+    int page;
+    GLintptr offset;
+    GLsizeiptr size;
+    int order;
+  };
+
+  GLsizeiptr PageSize;
+  GLsizeiptr MinBlock;
+  std::vector<Page> Pages;
+  std::vector<Allocation> Allocations;
+  std::vector<AllocationId> FreeIds;
+  GLsizeiptr Moved;
+
+  int orderOf(const GLsizeiptr size) const;
+  int createPage(const int order);
+  void releasePage(const int page);
+  GLintptr allocateBlock(Page &page, const int order);
+  void freeBlock(Page &page, GLintptr offset, int order);
+  bool place(const int order, const int exclude, int &page, GLintptr &offset);
+  const Allocation &lookup(const AllocationId id) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_BUFFER_HEAP_HPP */
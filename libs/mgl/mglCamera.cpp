@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Camera Abstraction Class
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglCamera.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////////// Camera
+
+// Owns the uniform buffer behind the CAMERA_BLOCK convention, bound once to
+// its binding point and shared by every program that declares
+//
+//   layout(std140) uniform Camera {
+//     mat4 ViewMatrix;
+//     mat4 ProjectionMatrix;
+//   };
+//
+// and registers it with addUniformBlock(CAMERA_BLOCK, binding_point). Setters
+// only mark a matrix dirty; update() uploads the dirty ones, so switching
+// programs never re-uploads camera state. Every binding of the buffer goes
+// through the StateCache, since update() relies on the cached generic
+// GL_UNIFORM_BUFFER binding.
+
+Camera::Camera(const GLuint binding_point)
+    : UboId(0), BindingPoint(binding_point), ViewMatrix(1.0f),
+      ProjectionMatrix(1.0f), ViewDirty(true), ProjectionDirty(true) {
+  StateCache &state = StateCache::getInstance();
+  Ubo = Resources::getInstance().createBuffer();
+  UboId = Resources::getInstance().get(Ubo);
+  state.bindBuffer(GL_UNIFORM_BUFFER, UboId);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4) * 2, 0, GL_DYNAMIC_DRAW);
+  state.bindBufferBase(GL_UNIFORM_BUFFER, BindingPoint, UboId);
+  state.bindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+Camera::~Camera() { Resources::getInstance().destroy(Ubo); }
+
+const glm::mat4 &Camera::getViewMatrix() const { return ViewMatrix; }
+
+void Camera::setViewMatrix(const glm::mat4 &view_matrix) {
+  if (view_matrix != ViewMatrix) {
+    ViewMatrix = view_matrix;
+    ViewDirty = true;
+  }
+}
+
+const glm::mat4 &Camera::getProjectionMatrix() const {
+  return ProjectionMatrix;
+}
+
+void Camera::setProjectionMatrix(const glm::mat4 &projection_matrix) {
+  if (projection_matrix != ProjectionMatrix) {
+    ProjectionMatrix = projection_matrix;
+    ProjectionDirty = true;
+  }
+}
+
+GLuint Camera::getBindingPoint() const { return BindingPoint; }
+
+void Camera::update() {
+  if (!ViewDirty && !ProjectionDirty) {
+    return;
+  }
+  StateCache &state = StateCache::getInstance();
+  state.bindBuffer(GL_UNIFORM_BUFFER, UboId);
+  if (ViewDirty) {
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4),
+                    glm::value_ptr(ViewMatrix));
+  }
+  if (ProjectionDirty) {
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4),
+                    glm::value_ptr(ProjectionMatrix));
+  }
+  ViewDirty = ProjectionDirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
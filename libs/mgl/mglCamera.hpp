@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Camera Abstraction Class
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_CAMERA_HPP
+#define MGL_CAMERA_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "./mglResources.hpp"
+
+namespace mgl {
+
+class Camera;
+
+///////////////////////////////////////////////////////////////////////// Camera
+
+class Camera {
+public:
+  explicit Camera(const GLuint binding_point);
+  ~Camera();
+
+  Camera(const Camera &) = delete;
+  Camera &operator=(const Camera &) = delete;
+
+  const glm::mat4 &getViewMatrix() const;
+  void setViewMatrix(const glm::mat4 &view_matrix);
+  const glm::mat4 &getProjectionMatrix() const;
+  void setProjectionMatrix(const glm::mat4 &projection_matrix);
+  GLuint getBindingPoint() const;
+  void update();
+
+private:
+  BufferHandle Ubo;
+  GLuint UboId;
+  GLuint BindingPoint;
+  glm::mat4 ViewMatrix;
+  glm::mat4 ProjectionMatrix;
+  bool ViewDirty, ProjectionDirty;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_CAMERA_HPP */
@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Command List
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglCommandList.hpp"
+
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+//////////////////////////////////////////////////////////////////// CommandList
+
+// Deferred GL work recorded on any thread and replayed, in order, on the
+// thread that owns the GL context. Commands are plain structs written back
+// to back into fixed-size blocks, each preceded by an 8-byte header holding
+// its opcode and total size; a NEXT_BLOCK header ends a block early when the
+// next command does not fit. clear() rewinds the cursor but keeps the
+// blocks, so after the first few frames recording never allocates. A list
+// may only be recorded by one thread at a time: worker threads each record
+// their own list, which the frame list then replays with call().
+
+const size_t CommandList::DEFAULT_BLOCK_SIZE;
+
+namespace {
+
+struct ProgramCmd {
+  ShaderProgram *program;
+};
+
+struct ListCmd {
+  const CommandList *list;
+};
+
+struct BufferCmd {
+  GLenum target;
+  GLuint buffer;
+};
+
+struct BufferRangeCmd {
+  GLenum target;
+  GLuint index;
+  GLuint buffer;
+  GLintptr offset;
+  GLsizeiptr size;
+};
+
+struct TextureCmd {
+  GLuint unit;
+  GLenum target;
+  GLuint texture;
+};
+
+template <typename T> struct UniformCmd {
+  ShaderProgram *program;
+  ShaderProgram::UniformHandle handle;
+  T value;
+};
+
+struct DrawArraysCmd {
+  GLenum mode;
+  GLint first;
+  GLsizei count;
+};
+
+struct DrawElementsCmd {
+  GLenum mode;
+  GLsizei count;
+  GLenum type;
+  GLsizei instances;
+  GLsizeiptr offset;
+};
+
+const size_t ALIGNMENT = 8;
+
+size_t align(const size_t size) {
+  return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+} // namespace
+
+CommandList::CommandList(const size_t block_size)
+    : BlockSize(align(block_size)), Current(0), Cursor(0), Count(0),
+      Bytes(0) {}
+
+CommandList::~CommandList() {}
+
+void *CommandList::push(const Op op, const size_t size) {
+  const size_t total = sizeof(Header) + align(size);
+  if (total + sizeof(Header) > BlockSize) {
+    std::cerr << "Command of " << total << " bytes does not fit a "
+              << BlockSize << " byte block." << std::endl;
+    throw std::runtime_error("Command list block too small.");
+  }
+  if (Blocks.empty()) {
+    Blocks.emplace_back(new GLubyte[BlockSize]);
+  } else if (Cursor + total + sizeof(Header) > BlockSize) {
+    new (Blocks[Current].get() + Cursor) Header{NEXT_BLOCK, 0};
+    if (++Current == Blocks.size()) {
+      Blocks.emplace_back(new GLubyte[BlockSize]);
+    }
+    Cursor = 0;
+  }
+  GLubyte *p = Blocks[Current].get() + Cursor;
+  new (p) Header{op, static_cast<GLuint>(total)};
+  Cursor += total;
+  Bytes += total;
+  Count++;
+  return p + sizeof(Header);
+}
+
+template <typename T> T *CommandList::push(const Op op) {
+  return new (push(op, sizeof(T))) T;
+}
+
+void CommandList::useProgram(ShaderProgram *program) {
+  push<ProgramCmd>(USE_PROGRAM)->program = program;
+}
+
+void CommandList::bindVertexArray(const GLuint vao) {
+  *push<GLuint>(BIND_VERTEX_ARRAY) = vao;
+}
+
+void CommandList::bindBuffer(const GLenum target, const GLuint buffer) {
+  *push<BufferCmd>(BIND_BUFFER) = {target, buffer};
+}
+
+void CommandList::bindBufferRange(const GLenum target, const GLuint index,
+                                  const GLuint buffer, const GLintptr offset,
+                                  const GLsizeiptr size) {
+  *push<BufferRangeCmd>(BIND_BUFFER_RANGE) = {target, index, buffer, offset,
+                                              size};
+}
+
+void CommandList::bindTexture(const GLuint unit, const GLenum target,
+                              const GLuint texture) {
+  *push<TextureCmd>(BIND_TEXTURE) = {unit, target, texture};
+}
+
+void CommandList::enable(const GLenum cap) { *push<GLenum>(ENABLE) = cap; }
+
+void CommandList::disable(const GLenum cap) { *push<GLenum>(DISABLE) = cap; }
+
+void CommandList::setMat4(ShaderProgram *program,
+                          const ShaderProgram::UniformHandle handle,
+                          const glm::mat4 &value) {
+  *push<UniformCmd<glm::mat4>>(SET_MAT4) = {program, handle, value};
+}
+
+void CommandList::setVec4(ShaderProgram *program,
+                          const ShaderProgram::UniformHandle handle,
+                          const glm::vec4 &value) {
+  *push<UniformCmd<glm::vec4>>(SET_VEC4) = {program, handle, value};
+}
+
+void CommandList::setVec3(ShaderProgram *program,
+                          const ShaderProgram::UniformHandle handle,
+                          const glm::vec3 &value) {
+  *push<UniformCmd<glm::vec3>>(SET_VEC3) = {program, handle, value};
+}
+
+void CommandList::setFloat(ShaderProgram *program,
+                           const ShaderProgram::UniformHandle handle,
+                           const GLfloat value) {
+  *push<UniformCmd<GLfloat>>(SET_FLOAT) = {program, handle, value};
+}
+
+void CommandList::setInt(ShaderProgram *program,
+                         const ShaderProgram::UniformHandle handle,
+                         const GLint value) {
+  *push<UniformCmd<GLint>>(SET_INT) = {program, handle, value};
+}
+
+void CommandList::drawArrays(const GLenum mode, const GLint first,
+                             const GLsizei count) {
+  *push<DrawArraysCmd>(DRAW_ARRAYS) = {mode, first, count};
+}
+
+void CommandList::drawElements(const GLenum mode, const GLsizei count,
+                               const GLenum type, const GLsizeiptr offset) {
+  *push<DrawElementsCmd>(DRAW_ELEMENTS) = {mode, count, type, 1, offset};
+}
+
+void CommandList::drawElementsInstanced(const GLenum mode, const GLsizei count,
+                                        const GLenum type,
+                                        const GLsizeiptr offset,
+                                        const GLsizei instances) {
+  *push<DrawElementsCmd>(DRAW_ELEMENTS_INSTANCED) = {mode, count, type,
+                                                     instances, offset};
+}
+
+// The called list must stay alive and unchanged until this one is executed.
+void CommandList::call(const CommandList &list) {
+  push<ListCmd>(CALL)->list = &list;
+}
+
+// Escape hatch for GL work without a dedicated command; the std::function
+// lives outside the byte stream and costs a heap allocation per capture.
+void CommandList::add(const std::function<void()> &command) {
+  *push<size_t>(CALLBACK) = Callbacks.size();
+  Callbacks.push_back(command);
+}
+
+void CommandList::execute() const {
+  StateCache &state = StateCache::getInstance();
+  size_t block = 0, offset = 0;
+  while (block < Blocks.size() && !(block == Current && offset == Cursor)) {
+    const GLubyte *p = Blocks[block].get() + offset;
+    const Header &header = *reinterpret_cast<const Header *>(p);
+    const void *cmd = p + sizeof(Header);
+    offset += header.size;
+    switch (header.op) {
+    case NEXT_BLOCK:
+      block++;
+      offset = 0;
+      break;
+    case USE_PROGRAM:
+      static_cast<const ProgramCmd *>(cmd)->program->bind();
+      break;
+    case BIND_VERTEX_ARRAY:
+      state.bindVertexArray(*static_cast<const GLuint *>(cmd));
+      break;
+    case BIND_BUFFER: {
+      const BufferCmd &c = *static_cast<const BufferCmd *>(cmd);
+      state.bindBuffer(c.target, c.buffer);
+      break;
+    }
+    case BIND_BUFFER_RANGE: {
+      const BufferRangeCmd &c = *static_cast<const BufferRangeCmd *>(cmd);
+      state.bindBufferRange(c.target, c.index, c.buffer, c.offset, c.size);
+      break;
+    }
+    case BIND_TEXTURE: {
+      const TextureCmd &c = *static_cast<const TextureCmd *>(cmd);
+      state.bindTexture(c.unit, c.target, c.texture);
+      break;
+    }
+    case ENABLE:
+      state.enable(*static_cast<const GLenum *>(cmd));
+      break;
+    case DISABLE:
+      state.disable(*static_cast<const GLenum *>(cmd));
+      break;
+    case SET_MAT4: {
+      auto &c = *static_cast<const UniformCmd<glm::mat4> *>(cmd);
+      c.program->setMat4(c.handle, c.value);
+      break;
+    }
+    case SET_VEC4: {
+      auto &c = *static_cast<const UniformCmd<glm::vec4> *>(cmd);
+      c.program->setVec4(c.handle, c.value);
+      break;
+    }
+    case SET_VEC3: {
+      auto &c = *static_cast<const UniformCmd<glm::vec3> *>(cmd);
+      c.program->setVec3(c.handle, c.value);
+      break;
+    }
+    case SET_FLOAT: {
+      auto &c = *static_cast<const UniformCmd<GLfloat> *>(cmd);
+      c.program->setFloat(c.handle, c.value);
+      break;
+    }
+    case SET_INT: {
+      auto &c = *static_cast<const UniformCmd<GLint> *>(cmd);
+      c.program->setInt(c.handle, c.value);
+      break;
+    }
+    case DRAW_ARRAYS: {
+      const DrawArraysCmd &c = *static_cast<const DrawArraysCmd *>(cmd);
+      glDrawArrays(c.mode, c.first, c.count);
+      break;
+    }
+    case DRAW_ELEMENTS: {
+      const DrawElementsCmd &c = *static_cast<const DrawElementsCmd *>(cmd);
+      glDrawElements(c.mode, c.count, c.type,
+                     reinterpret_cast<GLvoid *>(c.offset));
+      break;
+    }
+    case DRAW_ELEMENTS_INSTANCED: {
+      const DrawElementsCmd &c = *static_cast<const DrawElementsCmd *>(cmd);
+      glDrawElementsInstanced(c.mode, c.count, c.type,
+                              reinterpret_cast<GLvoid *>(c.offset),
+                              c.instances);
+      break;
+    }
+    case CALL:
+      static_cast<const ListCmd *>(cmd)->list->execute();
+      break;
+    case CALLBACK:
+      Callbacks[*static_cast<const size_t *>(cmd)]();
+      break;
+    }
+  }
+}
+
+void CommandList::clear() {
+  Current = Cursor = 0;
+  Count = Bytes = 0;
+  Callbacks.clear();
+}
+
+size_t CommandList::size() const { return Count; }
+
+size_t CommandList::bytes() const { return Bytes; }
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
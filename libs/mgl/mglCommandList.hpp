@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Command List
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_COMMAND_LIST_HPP
+#define MGL_COMMAND_LIST_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "./mglShader.hpp"
+
+namespace mgl {
+
+class CommandList;
+
+//////////////////////////////////////////////////////////////////// CommandList
+
+class CommandList final {
+public:
+  static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit CommandList(const size_t block_size = DEFAULT_BLOCK_SIZE);
+  ~CommandList();
+
+  CommandList(const CommandList &) = delete;
+  CommandList &operator=(const CommandList &) = delete;
+
+  void useProgram(ShaderProgram *program);
+  void bindVertexArray(const GLuint vao);
+  void bindBuffer(const GLenum target, const GLuint buffer);
+  void bindBufferRange(const GLenum target, const GLuint index,
+                       const GLuint buffer, const GLintptr offset,
+                       const GLsizeiptr size);
+  void bindTexture(const GLuint unit, const GLenum target,
+                   const GLuint texture);
+  void enable(const GLenum cap);
+  void disable(const GLenum cap);
+
+  void setMat4(ShaderProgram *program,
+               const ShaderProgram::UniformHandle handle,
+               const glm::mat4 &value);
+  void setVec4(ShaderProgram *program,
+               const ShaderProgram::UniformHandle handle,
+               const glm::vec4 &value);
+  void setVec3(ShaderProgram *program,
+               const ShaderProgram::UniformHandle handle,
+               const glm::vec3 &value);
+  void setFloat(ShaderProgram *program,
+                const ShaderProgram::UniformHandle handle, const GLfloat value);
+  void setInt(ShaderProgram *program, const ShaderProgram::UniformHandle handle,
+              const GLint value);
+
+  void drawArrays(const GLenum mode, const GLint first, const GLsizei count);
+  void drawElements(const GLenum mode, const GLsizei count, const GLenum type,
+                    const GLsizeiptr offset);
+  void drawElementsInstanced(const GLenum mode, const GLsizei count,
+                             const GLenum type, const GLsizeiptr offset,
+                             const GLsizei instances);
+
+  void call(const CommandList &list);
+  void add(const std::function<void()> &command);
+
+  void execute() const;
+  void clear();
+  size_t size() const;
+  size_t bytes() const;
+
+private:
+  enum Op : GLuint {
+    NEXT_BLOCK,
+    USE_PROGRAM,
+    BIND_VERTEX_ARRAY,
+    BIND_BUFFER,
+    BIND_BUFFER_RANGE,
+    BIND_TEXTURE,
+    ENABLE,
+    DISABLE,
+    SET_MAT4,
+    SET_VEC4,
+    SET_VEC3,
+    SET_FLOAT,
+    SET_INT,
+    DRAW_ARRAYS,
+    DRAW_ELEMENTS,
+    DRAW_ELEMENTS_INSTANCED,
+    CALL,
+    CALLBACK
+  };
+
+  struct Header {
+    GLuint op;
+    GLuint size;
+  };
+
+  const size_t BlockSize;
+  std::vector<std::unique_ptr<GLubyte[]>> Blocks;
+  size_t Current, Cursor;
+  size_t Count, Bytes;
+  std::vector<std::function<void()>> Callbacks;
+
+  void *push(const Op op, const size_t size);
+  template <typename T> T *push(const Op op);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_COMMAND_LIST_HPP */
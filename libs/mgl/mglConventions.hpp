@@ -13,19 +13,30 @@ namespace mgl {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const char MODEL_MATRIX[] = "ModelMatrix";
-const char NORMAL_MATRIX[] = "NormalMatrix";
-const char VIEW_MATRIX[] = "ViewMatrix";
-const char PROJECTION_MATRIX[] = "ProjectionMatrix";
-const char TEXTURE_MATRIX[] = "TextureMatrix";
-const char CAMERA_BLOCK[] = "Camera";
-
-const char POSITION_ATTRIBUTE[] = "inPosition";
-const char NORMAL_ATTRIBUTE[] = "inNormal";
-const char TEXCOORD_ATTRIBUTE[] = "inTexcoord";
-const char TANGENT_ATTRIBUTE[] = "inTangent";
-const char BITANGENT_ATTRIBUTE[] = "inBitangent";
-const char COLOR_ATTRIBUTE[] = "inColor";
+constexpr char MODEL_MATRIX[] = "ModelMatrix";
+constexpr char NORMAL_MATRIX[] = "NormalMatrix";
+constexpr char VIEW_MATRIX[] = "ViewMatrix";
+constexpr char PROJECTION_MATRIX[] = "ProjectionMatrix";
+constexpr char TEXTURE_MATRIX[] = "TextureMatrix";
+constexpr char CAMERA_BLOCK[] = "Camera";
+constexpr char DRAW_DATA_BLOCK[] = "DrawData";
+
+constexpr char POSITION_ATTRIBUTE[] = "inPosition";
+constexpr char NORMAL_ATTRIBUTE[] = "inNormal";
+constexpr char TEXCOORD_ATTRIBUTE[] = "inTexcoord";
+constexpr char TANGENT_ATTRIBUTE[] = "inTangent";
+constexpr char BITANGENT_ATTRIBUTE[] = "inBitangent";
+constexpr char COLOR_ATTRIBUTE[] = "inColor";
+constexpr char INSTANCE_MATRIX_ATTRIBUTE[] = "inInstanceMatrix";
+constexpr char INSTANCE_COLOR_ATTRIBUTE[] = "inInstanceColor";
+
+// 32-bit FNV-1a hash of a shader variable name, evaluated at compile time
+// when given one of the names above, e.g. hashName(MODEL_MATRIX).
+constexpr unsigned hashName(const char *name, unsigned hash = 2166136261u) {
+  return *name ? hashName(name + 1, (hash ^ static_cast<unsigned char>(*name)) *
+                                        16777619u)
+               : hash;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 } // namespace mgl
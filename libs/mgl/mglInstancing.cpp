@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Instanced Rendering
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglInstancing.hpp"
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+////////////////////////////////////////////////////////////////// InstanceBatch
+
+// Adds a per-instance buffer to an existing mesh VAO so that every instance of
+// the mesh is drawn with a single glDrawElementsInstanced. The model matrix
+// takes four consecutive attribute locations starting at 'first_attribute'
+// and the color the one after, all with a divisor of 1:
+//
+//   layout(location = 2) in mat4 inInstanceMatrix;
+//   layout(location = 6) in vec4 inInstanceColor;
+//
+// Instances are collected on the CPU each frame and uploaded in one call,
+// orphaning the previous storage so the driver never waits on it.
+
+InstanceBatch::InstanceBatch() : VaoId(0), BufferId(0), Capacity(0) {}
+
+InstanceBatch::~InstanceBatch() { destroy(); }
+
+void InstanceBatch::create(const GLuint vao, const GLuint first_attribute) {
+  StateCache &state = StateCache::getInstance();
+  const GLuint previous = state.getVertexArray();
+  VaoId = vao;
+  Buffer = Resources::getInstance().createBuffer();
+  BufferId = Resources::getInstance().get(Buffer);
+  state.bindVertexArray(VaoId);
+  state.bindBuffer(GL_ARRAY_BUFFER, BufferId);
+  for (GLuint c = 0; c < 4; ++c) {
+    const GLuint attribute = first_attribute + c;
+    glEnableVertexAttribArray(attribute);
+    glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                          reinterpret_cast<GLvoid *>(c * sizeof(glm::vec4)));
+    glVertexAttribDivisor(attribute, 1);
+  }
+  glEnableVertexAttribArray(first_attribute + 4);
+  glVertexAttribPointer(first_attribute + 4, 4, GL_FLOAT, GL_FALSE,
+                        sizeof(Instance),
+                        reinterpret_cast<GLvoid *>(sizeof(glm::mat4)));
+  glVertexAttribDivisor(first_attribute + 4, 1);
+  state.bindVertexArray(previous == StateCache::UNKNOWN ? 0 : previous);
+}
+
+void InstanceBatch::destroy() {
+  if (BufferId) {
+    Resources::getInstance().destroy(Buffer);
+    Buffer = BufferHandle();
+    BufferId = 0;
+    Capacity = 0;
+  }
+}
+
+void InstanceBatch::add(const glm::mat4 &model, const glm::vec4 &color) {
+  Instances.push_back({model, color});
+}
+
+void InstanceBatch::clear() { Instances.clear(); }
+
+size_t InstanceBatch::size() { return Instances.size(); }
+
+void InstanceBatch::draw(const GLenum mode, const GLsizei count,
+                         const GLenum index_type, const GLsizeiptr offset) {
+  if (Instances.empty()) {
+    return;
+  }
+  StateCache &state = StateCache::getInstance();
+  const GLsizeiptr bytes = Instances.size() * sizeof(Instance);
+  state.bindBuffer(GL_ARRAY_BUFFER, BufferId);
+  if (bytes > Capacity) {
+    Capacity = bytes;
+  }
+  glBufferData(GL_ARRAY_BUFFER, Capacity, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, Instances.data());
+  state.bindVertexArray(VaoId);
+  glDrawElementsInstanced(mode, count, index_type,
+                          reinterpret_cast<GLvoid *>(offset),
+                          static_cast<GLsizei>(Instances.size()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
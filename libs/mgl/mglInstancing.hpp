@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Instanced Rendering
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_INSTANCING_HPP
+#define MGL_INSTANCING_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "./mglResources.hpp"
+
+namespace mgl {
+
+class InstanceBatch;
+
+////////////////////////////////////////////////////////////////// InstanceBatch
+
+class InstanceBatch final {
+public:
+  struct Instance {
+    glm::mat4 model;
+    glm::vec4 color;
+  };
+
+  InstanceBatch();
+  ~InstanceBatch();
+
+  InstanceBatch(const InstanceBatch &) = delete;
+  InstanceBatch &operator=(const InstanceBatch &) = delete;
+
+  void create(const GLuint vao, const GLuint first_attribute);
+  void destroy();
+  void add(const glm::mat4 &model, const glm::vec4 &color);
+  void clear();
+  size_t size();
+  void draw(const GLenum mode, const GLsizei count, const GLenum index_type,
+            const GLsizeiptr offset = 0);
+
+private:
+  GLuint VaoId;
+  BufferHandle Buffer;
+  GLuint BufferId;
+  GLsizeiptr Capacity;
+  std::vector<Instance> Instances;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_INSTANCING_HPP */
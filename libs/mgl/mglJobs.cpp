@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Job System
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglJobs.hpp"
+
+#include <algorithm>
+
+namespace mgl {
+
+////////////////////////////////////////////////////////////////////// JobSystem
+
+// A work-stealing scheduler. Every worker thread owns a deque, and queue 0
+// belongs to the threads that did not come from the pool, such as the main
+// thread. run() pushes onto the caller's own deque and increments the job's
+// counter. A thread takes work from the back of its own deque and steals
+// from the front of the others. wait() keeps the caller executing jobs until
+// the counter reaches zero, so the main thread participates, and jobs may
+// spawn and wait on child counters of their own. An exception thrown by a
+// job is stored in its counter and rethrown by wait(); only the first one is
+// kept. Jobs must not issue GL calls; only the thread that owns the context
+// may.
+
+static thread_local unsigned WorkerIndex = 0;
+
+JobSystem::JobSystem() : Running(false), Queued(0) {
+  Queues.emplace_back(new Queue());
+}
+
+JobSystem::~JobSystem() { stop(); }
+
+void JobSystem::start(unsigned workers) {
+  if (Running) {
+    return;
+  }
+  if (workers == 0) {
+    const unsigned cores = std::thread::hardware_concurrency();
+    workers = cores > 1 ? cores - 1 : 1;
+  }
+  Running = true;
+  for (unsigned i = 1; i <= workers; ++i) {
+    Queues.emplace_back(new Queue());
+  }
+  for (unsigned i = 1; i <= workers; ++i) {
+    Threads.emplace_back(&JobSystem::worker, this, i);
+  }
+}
+
+void JobSystem::stop() {
+  if (!Running) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    Running = false;
+  }
+  WakeUp.notify_all();
+  for (std::thread &thread : Threads) {
+    thread.join();
+  }
+  Threads.clear();
+  Queues.resize(1);
+}
+
+unsigned JobSystem::getWorkerCount() {
+  return static_cast<unsigned>(Threads.size());
+}
+
+void JobSystem::run(Counter &counter, const std::function<void()> &job) {
+  counter.pending++;
+  if (Threads.empty()) {
+    invoke(job, counter);
+    return;
+  }
+  Queue &queue = *Queues[WorkerIndex];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back({job, &counter});
+  }
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    Queued++;
+  }
+  WakeUp.notify_one();
+}
+
+void JobSystem::invoke(const std::function<void()> &function,
+                       Counter &counter) {
+  try {
+    function();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(counter.mutex);
+    if (!counter.error) {
+      counter.error = std::current_exception();
+    }
+  }
+  counter.pending--;
+}
+
+bool JobSystem::execute(const unsigned self) {
+  Job job;
+  bool found = false;
+  const size_t n = Queues.size();
+  for (size_t i = 0; i < n && !found; ++i) {
+    const size_t victim = (self + i) % n;
+    Queue &queue = *Queues[victim];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.jobs.empty()) {
+      if (victim == self) {
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+      } else {
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+      }
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  Queued--;
+  invoke(job.function, *job.counter);
+  return true;
+}
+
+void JobSystem::wait(Counter &counter) {
+  while (counter.pending > 0) {
+    if (!execute(WorkerIndex)) {
+      std::this_thread::yield();
+    }
+  }
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(counter.mutex);
+    std::swap(error, counter.error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void JobSystem::worker(const unsigned index) {
+  WorkerIndex = index;
+  while (Running) {
+    if (execute(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(SleepMutex);
+    WakeUp.wait(lock, [this] { return Queued > 0 || !Running; });
+  }
+}
+
+void JobSystem::parallelFor(const size_t count, const size_t grain,
+                            const std::function<void(size_t, size_t)> &body) {
+  Counter counter;
+  const size_t step = std::max<size_t>(grain, 1);
+  for (size_t begin = 0; begin < count; begin += step) {
+    const size_t end = std::min(begin + step, count);
+    run(counter, [&body, begin, end] { body(begin, end); });
+  }
+  wait(counter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Job System
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_JOBS_HPP
+#define MGL_JOBS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mgl {
+
+class JobSystem;
+
+////////////////////////////////////////////////////////////////////// JobSystem
+
+class JobSystem final {
+public:
+  struct Counter {
+    std::atomic<int> pending{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+  };
+
+  JobSystem();
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  void start(unsigned workers = 0);
+  void stop();
+  unsigned getWorkerCount();
+  void run(Counter &counter, const std::function<void()> &job);
+  void wait(Counter &counter);
+  void parallelFor(const size_t count, const size_t grain,
+                   const std::function<void(size_t, size_t)> &body);
+
+private:
+  struct Job {
+    std::function<void()> function;
+    Counter *counter;
+  };
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::unique_ptr<Queue>> Queues;
+  std::vector<std::thread> Threads;
+  std::atomic<bool> Running;
+  std::atomic<int> Queued;
+  std::mutex SleepMutex;
+  std::condition_variable WakeUp;
+
+  static void invoke(const std::function<void()> &function, Counter &counter);
+  bool execute(const unsigned self);
+  void worker(const unsigned index);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_JOBS_HPP */
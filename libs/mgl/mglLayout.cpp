@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Program Layout Reflection
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglLayout.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "./mglConventions.hpp"
+
+namespace mgl {
+
+////////////////////////////////////////////////////////////////// ProgramLayout
+
+// Queries every active input, uniform, buffer variable, uniform block and
+// shader storage block of a linked program through
+// ARB_program_interface_query (core in OpenGL 4.3). Block members are sorted
+// by block so that each Block refers to a contiguous [first, first + count)
+// range of its variable table. Array names are stored without their "[0]"
+// suffix.
+
+bool ProgramLayout::isSupported() {
+  return GLEW_VERSION_4_3 || GLEW_ARB_program_interface_query;
+}
+
+void ProgramLayout::clear() {
+  Inputs.clear();
+  Uniforms.clear();
+  BufferVariables.clear();
+  UniformBlocks.clear();
+  StorageBlocks.clear();
+}
+
+static std::string resourceName(const GLuint program_id,
+                                const GLenum interface, const GLuint index,
+                                const GLint length) {
+  std::vector<char> name(length > 0 ? length : 1);
+  glGetProgramResourceName(program_id, interface, index,
+                           static_cast<GLsizei>(name.size()), nullptr,
+                           name.data());
+  std::string result(name.data());
+  const size_t n = result.size();
+  if (n > 3 && result.compare(n - 3, 3, "[0]") == 0) {
+    result.resize(n - 3);
+  }
+  return result;
+}
+
+void ProgramLayout::reflectVariables(const GLuint program_id,
+                                     const GLenum interface,
+                                     std::vector<Variable> &variables) {
+  const GLenum props[] = {GL_NAME_LENGTH,  GL_TYPE,         GL_LOCATION,
+                          GL_BLOCK_INDEX,  GL_OFFSET,       GL_ARRAY_SIZE,
+                          GL_ARRAY_STRIDE, GL_MATRIX_STRIDE,
+                          GL_TOP_LEVEL_ARRAY_STRIDE};
+  // Each interface only accepts a subset of the properties above.
+  GLsizei count;
+  GLint defaults[] = {0, 0, -1, -1, -1, 1, 0, 0, 0};
+  std::vector<GLenum> query;
+  std::vector<int> slot;
+  for (int i = 0; i < 9; ++i) {
+    const GLenum p = props[i];
+    const bool input = interface == GL_PROGRAM_INPUT;
+    const bool buffer = interface == GL_BUFFER_VARIABLE;
+    if (input && p != GL_NAME_LENGTH && p != GL_TYPE && p != GL_LOCATION &&
+        p != GL_ARRAY_SIZE)
+      continue;
+    if (buffer && p == GL_LOCATION)
+      continue;
+    if (!buffer && p == GL_TOP_LEVEL_ARRAY_STRIDE)
+      continue;
+    query.push_back(p);
+    slot.push_back(i);
+  }
+
+  GLint active = 0;
+  glGetProgramInterfaceiv(program_id, interface, GL_ACTIVE_RESOURCES, &active);
+  variables.reserve(active);
+  for (GLint r = 0; r < active; ++r) {
+    GLint values[9], result[9];
+    std::copy(defaults, defaults + 9, values);
+    glGetProgramResourceiv(program_id, interface, r,
+                           static_cast<GLsizei>(query.size()), query.data(),
+                           static_cast<GLsizei>(query.size()), &count, result);
+    for (GLsizei i = 0; i < count; ++i) {
+      values[slot[i]] = result[i];
+    }
+    Variable v;
+    v.name = resourceName(program_id, interface, r, values[0]);
+    v.hash = hashName(v.name.c_str());
+    v.type = static_cast<GLenum>(values[1]);
+    v.location = values[2];
+    v.block = values[3];
+    v.offset = values[4];
+    v.array_size = values[5];
+    v.array_stride = values[6];
+    v.matrix_stride = values[7];
+    v.top_level_stride = values[8];
+    variables.push_back(v);
+  }
+}
+
+void ProgramLayout::reflectBlocks(const GLuint program_id,
+                                  const GLenum interface,
+                                  std::vector<Block> &blocks,
+                                  std::vector<Variable> &variables) {
+  std::stable_sort(variables.begin(), variables.end(),
+                   [](const Variable &a, const Variable &b) {
+                     return a.block < b.block;
+                   });
+
+  const GLenum props[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING,
+                          GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES};
+  GLint active = 0;
+  glGetProgramInterfaceiv(program_id, interface, GL_ACTIVE_RESOURCES, &active);
+  blocks.reserve(active);
+  for (GLint r = 0; r < active; ++r) {
+    GLint values[4];
+    glGetProgramResourceiv(program_id, interface, r, 4, props, 4, nullptr,
+                           values);
+    Block b;
+    b.name = resourceName(program_id, interface, r, values[0]);
+    b.hash = hashName(b.name.c_str());
+    b.binding = values[1];
+    b.data_size = values[2];
+    auto first = std::find_if(
+        variables.begin(), variables.end(),
+        [r](const Variable &v) { return v.block == r; });
+    b.first = static_cast<GLuint>(first - variables.begin());
+    b.count = static_cast<GLuint>(values[3]);
+    blocks.push_back(b);
+  }
+}
+
+void ProgramLayout::reflect(const GLuint program_id) {
+  clear();
+  if (!isSupported()) {
+    return;
+  }
+  reflectVariables(program_id, GL_PROGRAM_INPUT, Inputs);
+  reflectVariables(program_id, GL_UNIFORM, Uniforms);
+  reflectVariables(program_id, GL_BUFFER_VARIABLE, BufferVariables);
+  reflectBlocks(program_id, GL_UNIFORM_BLOCK, UniformBlocks, Uniforms);
+  reflectBlocks(program_id, GL_SHADER_STORAGE_BLOCK, StorageBlocks,
+                BufferVariables);
+}
+
+template <typename T>
+static const T *findHash(const std::vector<T> &v, const GLuint hash) {
+  for (const T &i : v) {
+    if (i.hash == hash) {
+      return &i;
+    }
+  }
+  return nullptr;
+}
+
+const ProgramLayout::Variable *
+ProgramLayout::findInput(const GLuint hash) const {
+  return findHash(Inputs, hash);
+}
+
+const ProgramLayout::Variable *
+ProgramLayout::findUniform(const GLuint hash) const {
+  return findHash(Uniforms, hash);
+}
+
+const ProgramLayout::Variable *
+ProgramLayout::findBufferVariable(const GLuint hash) const {
+  return findHash(BufferVariables, hash);
+}
+
+const ProgramLayout::Block *
+ProgramLayout::findUniformBlock(const GLuint hash) const {
+  return findHash(UniformBlocks, hash);
+}
+
+const ProgramLayout::Block *
+ProgramLayout::findStorageBlock(const GLuint hash) const {
+  return findHash(StorageBlocks, hash);
+}
+
+////////////////////////////////////////////////////////////////////// PACKING
+
+// Writes a value into a CPU copy of a block's contents at the offset, array
+// stride and matrix stride reported by the driver, so std140 and std430
+// padding never has to be computed by hand. Matrices are column-major.
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const GLint element, const void *value,
+                          const GLint columns, const size_t column_size) {
+  GLubyte *dst = data + var.offset + element * var.array_stride;
+  const GLubyte *src = static_cast<const GLubyte *>(value);
+  for (GLint c = 0; c < columns; ++c) {
+    std::memcpy(dst + c * var.matrix_stride, src + c * column_size,
+                column_size);
+  }
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const glm::mat4 &value, const GLint element) {
+  write(data, var, element, glm::value_ptr(value), 4, sizeof(value[0]));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const glm::mat3 &value, const GLint element) {
+  write(data, var, element, glm::value_ptr(value), 3, sizeof(value[0]));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const glm::vec4 &value, const GLint element) {
+  write(data, var, element, glm::value_ptr(value), 1, sizeof(value));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const glm::vec3 &value, const GLint element) {
+  write(data, var, element, glm::value_ptr(value), 1, sizeof(value));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const glm::vec2 &value, const GLint element) {
+  write(data, var, element, glm::value_ptr(value), 1, sizeof(value));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const GLfloat value, const GLint element) {
+  write(data, var, element, &value, 1, sizeof(value));
+}
+
+void ProgramLayout::write(GLubyte *data, const Variable &var,
+                          const GLint value, const GLint element) {
+  write(data, var, element, &value, 1, sizeof(value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
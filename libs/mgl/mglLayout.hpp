@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Program Layout Reflection
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_LAYOUT_HPP
+#define MGL_LAYOUT_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+class ProgramLayout;
+
+////////////////////////////////////////////////////////////////// ProgramLayout
+
+class ProgramLayout final {
+public:
+  struct Variable {
+    std::string name;
+    GLuint hash;
+    GLenum type;
+    GLint location;
+    GLint block;
+    GLint offset;
+    GLint array_size;
+    GLint array_stride;
+    GLint matrix_stride;
+    GLint top_level_stride;
+  };
+  std::vector<Variable> Inputs;
+  std::vector<Variable> Uniforms;
+  std::vector<Variable> BufferVariables;
+
+  struct Block {
+    std::string name;
+    GLuint hash;
+    GLint binding;
+    GLint data_size;
+    GLuint first;
+    GLuint count;
+  };
+  std::vector<Block> UniformBlocks;
+  std::vector<Block> StorageBlocks;
+
+  static bool isSupported();
+  void reflect(const GLuint program_id);
+  void clear();
+
+  const Variable *findInput(const GLuint hash) const;
+  const Variable *findUniform(const GLuint hash) const;
+  const Variable *findBufferVariable(const GLuint hash) const;
+  const Block *findUniformBlock(const GLuint hash) const;
+  const Block *findStorageBlock(const GLuint hash) const;
+
+  static void write(GLubyte *data, const Variable &var, const glm::mat4 &value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const glm::mat3 &value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const glm::vec4 &value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const glm::vec3 &value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const glm::vec2 &value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const GLfloat value,
+                    const GLint element = 0);
+  static void write(GLubyte *data, const Variable &var, const GLint value,
+                    const GLint element = 0);
+
+private:
+  static void write(GLubyte *data, const Variable &var, const GLint element,
+                    const void *value, const GLint columns,
+                    const size_t column_size);
+  void reflectVariables(const GLuint program_id, const GLenum interface,
+                        std::vector<Variable> &variables);
+  void reflectBlocks(const GLuint program_id, const GLenum interface,
+                     std::vector<Block> &blocks,
+                     std::vector<Variable> &variables);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_LAYOUT_HPP */
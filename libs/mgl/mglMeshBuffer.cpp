@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Multi-Draw Indirect Mesh Buffer
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglMeshBuffer.hpp"
+
+#include <stdexcept>
+
+#include "./mglState.hpp"
+#include "./mglVertexFormat.hpp"
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////// MeshBuffer
+
+// Packs the vertices and 32-bit indices of many meshes sharing one vertex
+// layout into a single VBO/IBO pair behind one VAO. Each frame, addDraw()
+// appends a DrawElementsIndirectCommand plus its per-draw data, and draw()
+// renders them all with one glMultiDrawElementsIndirect (OpenGL 4.6 for
+// gl_DrawID). The per-draw data is a shader storage block indexed by
+// gl_DrawID; base_instance also holds the draw index for shaders that fetch
+// it through gl_BaseInstance instead:
+//
+//   struct Draw { mat4 Model; vec4 Color; };
+//   layout(std430, binding = 0) readonly buffer DrawData { Draw Draws[]; };
+
+enum { VERTICES, INDICES, COMMANDS, DATA };
+
+MeshBuffer::MeshBuffer(const GLsizei vertex_stride)
+    : Stride(vertex_stride), VaoId(0), BufferId{0, 0, 0, 0},
+      CommandCapacity(0), DataCapacity(0) {}
+
+MeshBuffer::~MeshBuffer() { destroy(); }
+
+GLuint MeshBuffer::addMesh(const void *vertices, const GLuint vertex_count,
+                           const GLuint *indices, const GLuint index_count) {
+  const MeshInfo mesh = {static_cast<GLuint>(Indices.size()), index_count,
+                         static_cast<GLint>(Vertices.size() / Stride),
+                         vertex_count};
+  const GLubyte *bytes = static_cast<const GLubyte *>(vertices);
+  Vertices.insert(Vertices.end(), bytes, bytes + vertex_count * Stride);
+  Indices.insert(Indices.end(), indices, indices + index_count);
+  Meshes.push_back(mesh);
+  return static_cast<GLuint>(Meshes.size() - 1);
+}
+
+void MeshBuffer::addAttribute(const GLuint index, const GLint size,
+                              const GLenum type, const GLboolean normalized,
+                              const GLsizeiptr offset) {
+  Attributes.push_back({index, size, type, normalized, offset});
+}
+
+void MeshBuffer::create() {
+  StateCache &state = StateCache::getInstance();
+  Resources &resources = Resources::getInstance();
+  Vao = resources.createVertexArray();
+  VaoId = resources.get(Vao);
+  for (int i = 0; i < 4; ++i) {
+    Buffers[i] = resources.createBuffer();
+    BufferId[i] = resources.get(Buffers[i]);
+  }
+  state.bindVertexArray(VaoId);
+  {
+    state.bindBuffer(GL_ARRAY_BUFFER, BufferId[VERTICES]);
+    glBufferData(GL_ARRAY_BUFFER, Vertices.size(), Vertices.data(),
+                 GL_STATIC_DRAW);
+    for (const AttributeInfo &a : Attributes) {
+      glEnableVertexAttribArray(a.index);
+      if (VertexFormat::isInteger(a.type, a.normalized)) {
+        glVertexAttribIPointer(a.index, a.size, a.type, Stride,
+                               reinterpret_cast<GLvoid *>(a.offset));
+      } else {
+        glVertexAttribPointer(a.index, a.size, a.type, a.normalized, Stride,
+                              reinterpret_cast<GLvoid *>(a.offset));
+      }
+    }
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferId[INDICES]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(GLuint),
+                 Indices.data(), GL_STATIC_DRAW);
+  }
+  state.bindVertexArray(0);
+  Vertices.clear();
+  Vertices.shrink_to_fit();
+  Indices.clear();
+  Indices.shrink_to_fit();
+}
+
+void MeshBuffer::destroy() {
+  if (VaoId) {
+    Resources &resources = Resources::getInstance();
+    resources.destroy(Vao);
+    for (int i = 0; i < 4; ++i) {
+      resources.destroy(Buffers[i]);
+      BufferId[i] = 0;
+    }
+    VaoId = 0;
+  }
+}
+
+void MeshBuffer::addDraw(const GLuint mesh, const glm::mat4 &model,
+                         const glm::vec4 &color) {
+  if (mesh >= Meshes.size()) {
+    throw std::runtime_error("Invalid mesh index.");
+  }
+  const MeshInfo &m = Meshes[mesh];
+  Commands.push_back({m.index_count, 1, m.first_index, m.base_vertex,
+                      static_cast<GLuint>(Commands.size())});
+  Data.push_back({model, color});
+}
+
+void MeshBuffer::clearDraws() {
+  Commands.clear();
+  Data.clear();
+}
+
+static void upload(const GLenum target, const GLsizeiptr bytes,
+                   const void *data, GLsizeiptr &capacity) {
+  if (bytes > capacity) {
+    capacity = bytes;
+  }
+  glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(target, 0, bytes, data);
+}
+
+void MeshBuffer::draw(const GLenum mode, const GLuint binding_point) {
+  if (Commands.empty()) {
+    return;
+  }
+  StateCache &state = StateCache::getInstance();
+  state.bindBuffer(GL_SHADER_STORAGE_BUFFER, BufferId[DATA]);
+  upload(GL_SHADER_STORAGE_BUFFER, Data.size() * sizeof(DrawData), Data.data(),
+         DataCapacity);
+  state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, binding_point,
+                       BufferId[DATA]);
+  state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, BufferId[COMMANDS]);
+  upload(GL_DRAW_INDIRECT_BUFFER, Commands.size() * sizeof(DrawCommand),
+         Commands.data(), CommandCapacity);
+  state.bindVertexArray(VaoId);
+  glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr,
+                              static_cast<GLsizei>(Commands.size()), 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Multi-Draw Indirect Mesh Buffer
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_MESH_BUFFER_HPP
+#define MGL_MESH_BUFFER_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "./mglResources.hpp"
+
+namespace mgl {
+
+class MeshBuffer;
+
+///////////////////////////////////////////////////////////////////// MeshBuffer
+
+class MeshBuffer final {
+public:
+  struct DrawCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+  };
+  struct DrawData {
+    glm::mat4 model;
+    glm::vec4 color;
+  };
+  struct MeshInfo {
+    GLuint first_index;
+    GLuint index_count;
+    GLint base_vertex;
+    GLuint vertex_count;
+  };
+  std::vector<MeshInfo> Meshes;
+
+  explicit MeshBuffer(const GLsizei vertex_stride);
+  ~MeshBuffer();
+
+  MeshBuffer(const MeshBuffer &) = delete;
+  MeshBuffer &operator=(const MeshBuffer &) = delete;
+
+  GLuint addMesh(const void *vertices, const GLuint vertex_count,
+                 const GLuint *indices, const GLuint index_count);
+  void addAttribute(const GLuint index, const GLint size, const GLenum type,
+                    const GLboolean normalized, const GLsizeiptr offset);
+  void create();
+  void destroy();
+
+  void addDraw(const GLuint mesh, const glm::mat4 &model,
+               const glm::vec4 &color);
+  void clearDraws();
+  void draw(const GLenum mode, const GLuint binding_point = 0);
+
+private:
+  struct AttributeInfo {
+    GLuint index;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizeiptr offset;
+  };
+  GLsizei Stride;
+  VertexArrayHandle Vao;
+  BufferHandle Buffers[4];
+  GLuint VaoId;
+  GLuint BufferId[4];
+  GLsizeiptr CommandCapacity, DataCapacity;
+  std::vector<GLubyte> Vertices;
+  std::vector<GLuint> Indices;
+  std::vector<AttributeInfo> Attributes;
+  std::vector<DrawCommand> Commands;
+  std::vector<DrawData> Data;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_MESH_BUFFER_HPP */
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Mesh Builder
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglMeshBuilder.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+//////////////////////////////////////////////////////////////////// MeshBuilder
+
+// Creates the vertex buffer, index buffer and VAO of an indexed mesh in one
+// go. With direct state access (OpenGL 4.5) buffers get immutable storage
+// through glNamedBufferStorage and the VAO is described with
+// glVertexArrayVertexBuffer / glVertexArrayAttribFormat /
+// glVertexArrayElementBuffer, so building any number of meshes leaves every
+// binding untouched. Older contexts fall back to bind-to-edit through the
+// StateCache, using glBufferStorage where available (4.4) and glBufferData
+// otherwise. The data pointers are only read by build().
+
+MeshBuilder::MeshBuilder(const VertexFormat &format)
+    : Format(format), Vertices(nullptr), VertexCount(0), Indices(nullptr),
+      IndexCount(0), IndexType(GL_UNSIGNED_INT), Flags(0) {}
+
+MeshBuilder::~MeshBuilder() {}
+
+MeshBuilder &MeshBuilder::setVertices(const void *data,
+                                      const GLsizei vertex_count) {
+  Vertices = data;
+  VertexCount = vertex_count;
+  return *this;
+}
+
+MeshBuilder &MeshBuilder::setIndices(const void *data,
+                                     const GLsizei index_count,
+                                     const GLenum index_type) {
+  Indices = data;
+  IndexCount = index_count;
+  IndexType = index_type;
+  return *this;
+}
+
+MeshBuilder &MeshBuilder::setStorageFlags(const GLbitfield flags) {
+  Flags = flags;
+  return *this;
+}
+
+static GLsizeiptr indexSize(const GLenum type) {
+  switch (type) {
+  case GL_UNSIGNED_BYTE:
+    return 1;
+  case GL_UNSIGNED_SHORT:
+    return 2;
+  case GL_UNSIGNED_INT:
+    return 4;
+  default:
+    std::cerr << "Unsupported index type " << type << "." << std::endl;
+    throw std::runtime_error("Unsupported index type.");
+  }
+}
+
+GLuint MeshBuilder::createBuffer(BufferHandle &handle, const GLsizeiptr size,
+                                 const void *data, const GLbitfield flags) {
+  Resources &resources = Resources::getInstance();
+  handle = resources.createBuffer();
+  const GLuint buffer = resources.get(handle);
+  if (StateCache::hasDirectStateAccess()) {
+    glNamedBufferStorage(buffer, size, data, flags);
+    return buffer;
+  }
+  StateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+    glBufferStorage(GL_COPY_WRITE_BUFFER, size, data, flags);
+  } else {
+    const GLenum usage =
+        (flags & GL_DYNAMIC_STORAGE_BIT) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+    glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+  }
+  return buffer;
+}
+
+MeshBuilder::Mesh MeshBuilder::build() {
+  if (!Vertices || VertexCount <= 0) {
+    throw std::runtime_error("Mesh has no vertices.");
+  }
+  Mesh mesh;
+  mesh.index_type = IndexType;
+  mesh.index_count = IndexCount;
+  mesh.vertex_count = VertexCount;
+
+  const GLuint vertices = createBuffer(
+      mesh.vertices, Format.getStride() * VertexCount, Vertices, Flags);
+  GLuint indices = 0;
+  if (Indices && IndexCount > 0) {
+    indices = createBuffer(mesh.indices, indexSize(IndexType) * IndexCount,
+                           Indices, Flags);
+  }
+
+  Resources &resources = Resources::getInstance();
+  mesh.vao = resources.createVertexArray();
+  const GLuint vao = resources.get(mesh.vao);
+  Format.apply(vao, vertices);
+  if (StateCache::hasDirectStateAccess()) {
+    glVertexArrayElementBuffer(vao, indices);
+  } else {
+    StateCache &state = StateCache::getInstance();
+    const GLuint previous = state.getVertexArray();
+    state.bindVertexArray(vao);
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
+    state.bindVertexArray(previous == StateCache::UNKNOWN ? 0 : previous);
+  }
+  return mesh;
+}
+
+void MeshBuilder::destroy(const Mesh &mesh) {
+  Resources &resources = Resources::getInstance();
+  resources.destroy(mesh.vao);
+  resources.destroy(mesh.vertices);
+  if (!mesh.indices.isNull()) {
+    resources.destroy(mesh.indices);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
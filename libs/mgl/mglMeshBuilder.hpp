@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Mesh Builder
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_MESH_BUILDER_HPP
+#define MGL_MESH_BUILDER_HPP
+
+#include <GL/glew.h>
+
+#include "./mglResources.hpp"
+#include "./mglVertexFormat.hpp"
+
+namespace mgl {
+
+class MeshBuilder;
+
+//////////////////////////////////////////////////////////////////// MeshBuilder
+
+class MeshBuilder final {
+public:
+  struct Mesh {
+    VertexArrayHandle vao;
+    BufferHandle vertices;
+    BufferHandle indices;
+    GLenum index_type;
+    GLsizei index_count;
+    GLsizei vertex_count;
+  };
+
+  explicit MeshBuilder(const VertexFormat &format);
+  ~MeshBuilder();
+
+  MeshBuilder &setVertices(const void *data, const GLsizei vertex_count);
+  MeshBuilder &setIndices(const void *data, const GLsizei index_count,
+                          const GLenum index_type);
+  MeshBuilder &setStorageFlags(const GLbitfield flags);
+  Mesh build();
+
+  static GLuint createBuffer(BufferHandle &handle, const GLsizeiptr size,
+                             const void *data, const GLbitfield flags);
+  static void destroy(const Mesh &mesh);
+
+private:
+  const VertexFormat &Format;
+  const void *Vertices;
+  GLsizei VertexCount;
+  const void *Indices;
+  GLsizei IndexCount;
+  GLenum IndexType;
+  GLbitfield Flags;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_MESH_BUILDER_HPP */
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Mesh Optimizer
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_MESH_OPTIMIZER_HPP
+#define MGL_MESH_OPTIMIZER_HPP
+
+#include <GL/glew.h>
+
+#include <vector>
+
+namespace mgl {
+
+class MeshOptimizer;
+
+////////////////////////////////////////////////////////////////// MeshOptimizer
+
+class MeshOptimizer final {
+public:
+  static const int FIFO_CACHE_SIZE = 16;
+  static const int LRU_CACHE_SIZE = 32;
+
+  struct Report {
+    GLuint vertices_before;
+    GLuint vertices_after;
+    GLuint triangles;
+    GLfloat acmr_before;
+    GLfloat acmr_after;
+    GLenum index_type;
+  };
+
+  explicit MeshOptimizer(const GLsizei vertex_stride);
+  ~MeshOptimizer();
+
+  Report optimize(std::vector<GLubyte> &vertices, std::vector<GLuint> &indices);
+
+  GLuint deduplicate(std::vector<GLubyte> &vertices,
+                     std::vector<GLuint> &indices);
+  void reorderTriangles(std::vector<GLuint> &indices,
+                        const GLuint vertex_count);
+  GLuint reorderVertices(std::vector<GLubyte> &vertices,
+                         std::vector<GLuint> &indices);
+
+  static GLfloat computeAcmr(const std::vector<GLuint> &indices,
+                             const GLuint vertex_count,
+                             const int cache_size = FIFO_CACHE_SIZE);
+  static GLenum indexType(const GLuint vertex_count);
+  static void packIndices(const std::vector<GLuint> &indices,
+                          const GLenum type, std::vector<GLubyte> &packed);
+
+private:
+  GLsizei Stride;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_MESH_OPTIMIZER_HPP */
@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Frame Profiler
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglProfiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace mgl {
+
+/////////////////////////////////////////////////////////////////////// Profiler
+
+// CPU zones are timed with a steady clock. GPU zones are bracketed by a pair of
+// GL_TIMESTAMP queries that are kept in a ring of RING_SIZE frames and only
+// read back when their slot is about to be reused, so the CPU never waits on
+// the GPU. Results that are still unavailable at that point are discarded.
+//
+// Zones are registered once by name and then referred to by id, so timing a
+// zone never allocates. Statistics are per frame: a zone's CPU and GPU times
+// are summed over the frame and kept in a rolling window of the last
+// HISTORY_SIZE frames in which it ran. Zone names must outlive the profiler
+// (string literals). A profiler is not thread safe; each thread that times
+// frames needs its own.
+
+const int Profiler::RING_SIZE;
+const size_t Profiler::HISTORY_SIZE;
+const size_t Profiler::MAX_EVENTS;
+const size_t Profiler::MAX_DEPTH;
+const Profiler::ZoneId Profiler::FRAME_ZONE;
+
+Profiler::Profiler()
+    : Enabled(false), Initialized(false),
+      Origin(std::chrono::steady_clock::now()), FrameStart(0.0),
+      RingIndex(0) {
+  for (GpuFrame &frame : Ring) {
+    frame.used = 0;
+    frame.start_us = 0.0;
+  }
+  FrameTimes = {std::vector<double>(HISTORY_SIZE), 0, 0.0, false};
+  Stack.reserve(MAX_DEPTH);
+  registerZone("Frame");
+}
+
+Profiler::~Profiler() {}
+
+void Profiler::setEnabled(bool enabled) {
+  Enabled = enabled;
+  if (Enabled) {
+    Events.reserve(MAX_EVENTS);
+  }
+}
+
+Profiler::ZoneId Profiler::registerZone(const char *name) {
+  for (size_t i = 0; i < Zones.size(); ++i) {
+    if (Zones[i].name == name || std::strcmp(Zones[i].name, name) == 0) {
+      return static_cast<ZoneId>(i);
+    }
+  }
+  const History empty = {std::vector<double>(HISTORY_SIZE), 0, 0.0, false};
+  Zones.push_back({name, empty, empty});
+  return static_cast<ZoneId>(Zones.size() - 1);
+}
+
+void Profiler::push(History &history, double value) {
+  history.values[history.count % HISTORY_SIZE] = value;
+  history.count++;
+}
+
+void Profiler::flush(History &history) {
+  if (history.active) {
+    push(history, history.current);
+  }
+  history.current = 0.0;
+  history.active = false;
+}
+
+double Profiler::average(const History &history) {
+  const size_t n = std::min(history.count, HISTORY_SIZE);
+  double total = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    total += history.values[i];
+  }
+  return n ? total / n : 0.0;
+}
+
+double Profiler::last(const History &history) {
+  return history.count ? history.values[(history.count - 1) % HISTORY_SIZE]
+                       : 0.0;
+}
+
+bool Profiler::isEnabled() { return Enabled; }
+
+void Profiler::init() { Initialized = true; }
+
+void Profiler::destroy() {
+  for (GpuFrame &frame : Ring) {
+    if (!frame.Queries.empty()) {
+      glDeleteQueries(static_cast<GLsizei>(frame.Queries.size()),
+                      frame.Queries.data());
+    }
+    frame.Queries.clear();
+    frame.Zones.clear();
+    frame.used = 0;
+  }
+  Initialized = false;
+}
+
+double Profiler::now() {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - Origin)
+      .count();
+}
+
+GLuint Profiler::nextQuery() {
+  GpuFrame &frame = Ring[RingIndex];
+  if (frame.used == frame.Queries.size()) {
+    GLuint query;
+    glGenQueries(1, &query);
+    frame.Queries.push_back(query);
+  }
+  return frame.Queries[frame.used++];
+}
+
+void Profiler::record(const ZoneId zone, double start_us, double duration_us,
+                      int track) {
+  if (Events.size() < MAX_EVENTS) {
+    Events.push_back({zone, start_us, duration_us, track});
+  }
+}
+
+void Profiler::collect(GpuFrame &frame) {
+  GLint available = 0;
+  if (!frame.Zones.empty()) {
+    glGetQueryObjectiv(frame.Zones.back().end_query, GL_QUERY_RESULT_AVAILABLE,
+                       &available);
+  }
+  if (available) {
+    GLuint64 origin_ns;
+    glGetQueryObjectui64v(frame.Zones.front().begin_query, GL_QUERY_RESULT,
+                          &origin_ns);
+    for (const GpuZone &zone : frame.Zones) {
+      GLuint64 begin_ns, end_ns;
+      glGetQueryObjectui64v(zone.begin_query, GL_QUERY_RESULT, &begin_ns);
+      glGetQueryObjectui64v(zone.end_query, GL_QUERY_RESULT, &end_ns);
+      const double duration_us = (end_ns - begin_ns) / 1000.0;
+      History &gpu = Zones[zone.zone].gpu;
+      gpu.current += duration_us / 1000.0;
+      gpu.active = true;
+      record(zone.zone, frame.start_us + (begin_ns - origin_ns) / 1000.0,
+             duration_us, 1);
+    }
+    for (Zone &zone : Zones) {
+      flush(zone.gpu);
+    }
+  }
+  frame.Zones.clear();
+  frame.used = 0;
+}
+
+void Profiler::beginFrame() {
+  if (!Enabled) {
+    return;
+  }
+  FrameStart = now();
+  if (Initialized) {
+    GpuFrame &frame = Ring[RingIndex];
+    collect(frame);
+    frame.start_us = FrameStart;
+  }
+}
+
+void Profiler::endFrame() {
+  if (!Enabled) {
+    return;
+  }
+  while (!Stack.empty()) {
+    endZone();
+  }
+  const double duration_us = now() - FrameStart;
+  record(FRAME_ZONE, FrameStart, duration_us, 0);
+  push(FrameTimes, duration_us / 1000.0);
+  for (Zone &zone : Zones) {
+    flush(zone.cpu);
+  }
+  RingIndex = (RingIndex + 1) % RING_SIZE;
+}
+
+void Profiler::beginZone(const ZoneId zone, bool gpu) {
+  if (!Enabled) {
+    return;
+  }
+  int gpu_zone = -1;
+  if (gpu && Initialized) {
+    GpuFrame &frame = Ring[RingIndex];
+    const GLuint query = nextQuery();
+    glQueryCounter(query, GL_TIMESTAMP);
+    gpu_zone = static_cast<int>(frame.Zones.size());
+    frame.Zones.push_back({zone, query, 0});
+  }
+  Stack.push_back({zone, now(), gpu_zone});
+}
+
+void Profiler::endZone() {
+  if (!Enabled || Stack.empty()) {
+    return;
+  }
+  const OpenZone zone = Stack.back();
+  Stack.pop_back();
+  if (zone.gpu_zone >= 0) {
+    const GLuint query = nextQuery();
+    glQueryCounter(query, GL_TIMESTAMP);
+    Ring[RingIndex].Zones[zone.gpu_zone].end_query = query;
+  }
+  const double duration_us = now() - zone.start_us;
+  History &cpu = Zones[zone.zone].cpu;
+  cpu.current += duration_us / 1000.0;
+  cpu.active = true;
+  record(zone.zone, zone.start_us, duration_us, 0);
+}
+
+// Frame times and zone times cover the last HISTORY_SIZE frames; the *_last_ms
+// values are those of the most recent frame (for GPU zones, the most recent
+// frame whose queries have been read back).
+Profiler::FrameStats Profiler::getStats() {
+  const size_t n = std::min(FrameTimes.count, HISTORY_SIZE);
+  FrameStats stats = {n, 0.0, 0.0, 0.0, {}};
+  if (n > 0) {
+    std::vector<double> sorted(FrameTimes.values.begin(),
+                               FrameTimes.values.begin() + n);
+    std::sort(sorted.begin(), sorted.end());
+    stats.min_ms = sorted.front();
+    stats.avg_ms = average(FrameTimes);
+    stats.p99_ms = sorted[(n - 1) * 99 / 100];
+  }
+  for (size_t i = 1; i < Zones.size(); ++i) {
+    const Zone &zone = Zones[i];
+    stats.zones.push_back({zone.name, average(zone.cpu), last(zone.cpu),
+                           average(zone.gpu), last(zone.gpu)});
+  }
+  return stats;
+}
+
+// Writes the recorded zones in the Chrome Trace Event format, viewable in
+// chrome://tracing or Perfetto. CPU zones go to thread 0, GPU zones to 1.
+void Profiler::dumpChromeTrace(const std::string &filename) {
+  std::ofstream ofile(filename);
+  if (!ofile.is_open()) {
+    std::cerr << "[ERROR] Failed to open trace file: " << filename;
+    throw std::runtime_error("Failed to open trace file.");
+  }
+  ofile << "{\"traceEvents\":[" << std::endl;
+  ofile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+           "\"args\":{\"name\":\"CPU\"}},"
+        << std::endl;
+  ofile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,"
+           "\"args\":{\"name\":\"GPU\"}}";
+  for (const Event &e : Events) {
+    ofile << "," << std::endl
+          << "{\"name\":\"" << Zones[e.zone].name
+          << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.track
+          << ",\"ts\":" << e.start_us << ",\"dur\":" << e.duration_us << "}";
+  }
+  ofile << std::endl << "]}" << std::endl;
+}
+
+//////////////////////////////////////////////////////////////////// ProfileZone
+
+ProfileZone::ProfileZone(Profiler &profiler, const Profiler::ZoneId zone,
+                         bool gpu)
+    : Owner(profiler) {
+  Owner.beginZone(zone, gpu);
+}
+
+ProfileZone::~ProfileZone() { Owner.endZone(); }
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Frame Profiler
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_PROFILER_HPP
+#define MGL_PROFILER_HPP
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+class Profiler;
+class ProfileZone;
+
+/////////////////////////////////////////////////////////////////////// Profiler
+
+class Profiler final {
+public:
+  static const int RING_SIZE = 4;
+  static const size_t HISTORY_SIZE = 256;
+  static const size_t MAX_EVENTS = 65536;
+  static const size_t MAX_DEPTH = 64;
+
+  typedef int ZoneId;
+  static const ZoneId FRAME_ZONE = 0;
+
+  struct ZoneStats {
+    const char *name;
+    double cpu_ms;
+    double cpu_last_ms;
+    double gpu_ms;
+    double gpu_last_ms;
+  };
+  struct FrameStats {
+    size_t frames;
+    double min_ms;
+    double avg_ms;
+    double p99_ms;
+    std::vector<ZoneStats> zones;
+  };
+
+  Profiler();
+  ~Profiler();
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  void setEnabled(bool enabled);
+  bool isEnabled();
+  void init();
+  void destroy();
+  void beginFrame();
+  void endFrame();
+  ZoneId registerZone(const char *name);
+  void beginZone(const ZoneId zone, bool gpu = false);
+  void endZone();
+  FrameStats getStats();
+  void dumpChromeTrace(const std::string &filename);
+
+private:
+  struct Event {
+    ZoneId zone;
+    double start_us;
+    double duration_us;
+    int track;
+  };
+  struct OpenZone {
+    ZoneId zone;
+    double start_us;
+    int gpu_zone;
+  };
+  struct GpuZone {
+    ZoneId zone;
+    GLuint begin_query;
+    GLuint end_query;
+  };
+  struct GpuFrame {
+    std::vector<GLuint> Queries;
+    std::vector<GpuZone> Zones;
+    size_t used;
+    double start_us;
+  };
+  struct History {
+    std::vector<double> values;
+    size_t count;
+    double current;
+    bool active;
+  };
+  struct Zone {
+    const char *name;
+    History cpu;
+    History gpu;
+  };
+
+  bool Enabled;
+  bool Initialized;
+  std::chrono::steady_clock::time_point Origin;
+  double FrameStart;
+  History FrameTimes;
+  std::vector<OpenZone> Stack;
+  std::vector<Event> Events;
+  GpuFrame Ring[RING_SIZE];
+  int RingIndex;
+  std::vector<Zone> Zones;
+
+  double now();
+  GLuint nextQuery();
+  void collect(GpuFrame &frame);
+  void record(const ZoneId zone, double start_us, double duration_us,
+              int track);
+  static void push(History &history, double value);
+  static void flush(History &history);
+  static double average(const History &history);
+  static double last(const History &history);
+};
+
+//////////////////////////////////////////////////////////////////// ProfileZone
+
+class ProfileZone final {
+public:
+  ProfileZone(Profiler &profiler, const Profiler::ZoneId zone,
+              bool gpu = false);
+  ~ProfileZone();
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+  Profiler &Owner;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_PROFILER_HPP */
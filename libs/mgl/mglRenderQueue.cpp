@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Sorted Render Queue
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglRenderQueue.hpp"
+
+#include <algorithm>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+//////////////////////////////////////////////////////////////////// RenderQueue
+
+// Draw items are encoded into 64-bit keys, from most to least significant:
+//
+//   [63..48] program   [47..32] VAO   [31..16] material   [15..0] depth
+//
+// and radix sorted (8 passes of 8 bits, skipping passes where every key has
+// the same byte). Executing in key order groups draws by program, then VAO,
+// then material, front to back, so the number of state switches follows the
+// number of distinct states rather than the number of draws. Ids are
+// truncated to 16 bits; a collision only affects grouping, not correctness.
+// Material uniforms belong to the program, so the material callback runs
+// again after every program switch even if the material id is unchanged.
+// clear() keeps the capacity of every array, so a queue reused each frame
+// stops allocating once it has seen its largest frame.
+
+RenderQueue::RenderQueue() : LastStats{0, 0, 0, 0} {}
+
+RenderQueue::~RenderQueue() {}
+
+void RenderQueue::setMaterialCallback(
+    const std::function<void(GLuint)> &callback) {
+  MaterialCallback = callback;
+}
+
+uint64_t RenderQueue::makeKey(const DrawItem &item) {
+  // NaN compares false, so it sorts as depth 0 instead of being converted.
+  const GLfloat depth =
+      !(item.depth > 0.0f) ? 0.0f : std::min(item.depth, 1.0f);
+  const uint64_t program = item.program->ProgramId & 0xFFFF;
+  const uint64_t vao = item.vao & 0xFFFF;
+  const uint64_t material = item.material & 0xFFFF;
+  const uint64_t z = static_cast<uint64_t>(depth * 65535.0f);
+  return (program << 48) | (vao << 32) | (material << 16) | z;
+}
+
+void RenderQueue::submit(const DrawItem &item) {
+  Keys.push_back(makeKey(item));
+  Order.push_back(static_cast<uint32_t>(Items.size()));
+  Items.push_back(item);
+}
+
+void RenderQueue::sort() {
+  const size_t n = Keys.size();
+  KeysTemp.resize(n);
+  OrderTemp.resize(n);
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t counts[256] = {0};
+    for (uint64_t key : Keys) {
+      counts[(key >> shift) & 0xFF]++;
+    }
+    if (n == 0 || counts[(Keys[0] >> shift) & 0xFF] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t &count : counts) {
+      const size_t c = count;
+      count = offset;
+      offset += c;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      const size_t dst = counts[(Keys[i] >> shift) & 0xFF]++;
+      KeysTemp[dst] = Keys[i];
+      OrderTemp[dst] = Order[i];
+    }
+    Keys.swap(KeysTemp);
+    Order.swap(OrderTemp);
+  }
+}
+
+void RenderQueue::execute() {
+  sort();
+  StateCache &state = StateCache::getInstance();
+  Stats stats = {0, 0, 0, 0};
+  const ShaderProgram *program = nullptr;
+  GLuint vao = StateCache::UNKNOWN;
+  GLuint material = StateCache::UNKNOWN;
+  for (uint32_t i : Order) {
+    DrawItem &item = Items[i];
+    if (item.program != program) {
+      item.program->bind();
+      program = item.program;
+      material = StateCache::UNKNOWN;
+      stats.program_switches++;
+    }
+    if (item.vao != vao) {
+      state.bindVertexArray(item.vao);
+      vao = item.vao;
+      stats.vao_switches++;
+    }
+    if (item.material != material) {
+      if (MaterialCallback)
+        MaterialCallback(item.material);
+      material = item.material;
+      stats.material_switches++;
+    }
+    item.program->setMat4(item.matrix, item.transform);
+    glDrawElements(item.mode, item.count, item.index_type,
+                   reinterpret_cast<GLvoid *>(item.offset));
+    stats.draws++;
+  }
+  LastStats = stats;
+  clear();
+}
+
+void RenderQueue::clear() {
+  Items.clear();
+  Keys.clear();
+  Order.clear();
+}
+
+size_t RenderQueue::size() { return Items.size(); }
+
+RenderQueue::Stats RenderQueue::getStats() { return LastStats; }
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
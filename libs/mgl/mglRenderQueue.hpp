@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Sorted Render Queue
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_RENDER_QUEUE_HPP
+#define MGL_RENDER_QUEUE_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "./mglShader.hpp"
+
+namespace mgl {
+
+class RenderQueue;
+
+//////////////////////////////////////////////////////////////////// RenderQueue
+
+class RenderQueue final {
+public:
+  struct DrawItem {
+    ShaderProgram *program;
+    GLuint vao;
+    GLuint material;
+    GLfloat depth;
+    ShaderProgram::UniformHandle matrix;
+    glm::mat4 transform;
+    GLenum mode;
+    GLsizei count;
+    GLenum index_type;
+    GLsizeiptr offset;
+  };
+
+  struct Stats {
+    unsigned draws;
+    unsigned program_switches;
+    unsigned vao_switches;
+    unsigned material_switches;
+  };
+
+  RenderQueue();
+  ~RenderQueue();
+
+  void setMaterialCallback(const std::function<void(GLuint)> &callback);
+  void submit(const DrawItem &item);
+  void sort();
+  void execute();
+  void clear();
+  size_t size();
+  Stats getStats();
+
+  static uint64_t makeKey(const DrawItem &item);
+
+private:
+  std::vector<DrawItem> Items;
+  std::vector<uint64_t> Keys, KeysTemp;
+  std::vector<uint32_t> Order, OrderTemp;
+  std::function<void(GLuint)> MaterialCallback;
+  Stats LastStats;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_RENDER_QUEUE_HPP */
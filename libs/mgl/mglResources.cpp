@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Generational Resource Pools
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglResources.hpp"
+
+#include <limits>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////////// Traits
+
+// With direct state access (OpenGL 4.5) buffers and vertex arrays are made
+// with glCreate*, which creates the object itself and not just its name, so
+// it can be edited through the glNamed*/glVertexArray* entry points without
+// ever being bound.
+
+GLuint BufferTraits::create() {
+  GLuint id;
+  if (StateCache::hasDirectStateAccess())
+    glCreateBuffers(1, &id);
+  else
+    glGenBuffers(1, &id);
+  return id;
+}
+
+void BufferTraits::destroy(const GLuint id) {
+  glDeleteBuffers(1, &id);
+  StateCache::getInstance().forgetBuffer(id);
+}
+
+GLuint VertexArrayTraits::create() {
+  GLuint id;
+  if (StateCache::hasDirectStateAccess())
+    glCreateVertexArrays(1, &id);
+  else
+    glGenVertexArrays(1, &id);
+  return id;
+}
+
+void VertexArrayTraits::destroy(const GLuint id) {
+  glDeleteVertexArrays(1, &id);
+  StateCache::getInstance().forgetVertexArray(id);
+}
+
+GLuint ProgramTraits::create() { return glCreateProgram(); }
+
+void ProgramTraits::destroy(const GLuint id) {
+  glDeleteProgram(id);
+  StateCache::getInstance().forgetProgram(id);
+}
+
+GLuint TextureTraits::create() {
+  GLuint id;
+  glGenTextures(1, &id);
+  return id;
+}
+
+void TextureTraits::destroy(const GLuint id) {
+  glDeleteTextures(1, &id);
+  StateCache::getInstance().forgetTexture(id);
+}
+
+////////////////////////////////////////////////////////////////////// Resources
+
+// Owns one pool per GL object type. Objects destroyed during frame N are
+// deleted once the fence inserted by newFrame() at the end of frame N has
+// signalled, so draws already submitted may keep using them. newFrame()
+// never blocks: it only polls the oldest fences. flush() waits for the GPU
+// and deletes everything still pending; the Engine calls it at shutdown.
+//
+// Every method locks the registry, so with a render thread the main thread
+// may destroy() and get() while the render thread runs newFrame(). Creation
+// issues GL calls and must still happen on the thread that owns the context.
+// The pools themselves are not locked and are only safe to touch directly
+// when no other thread uses the registry.
+//
+// Frame counts the frames ended by newFrame() on the GL thread. When other
+// threads record frames ahead of it, setLatency() says by how many, and
+// deletions are tagged with the frame being recorded rather than the one
+// being executed, so a list recorded before the destroy() still finds its
+// objects when it is replayed.
+
+Resources::Resources() : Frame(0), Latency(0) {}
+
+Resources::~Resources() {}
+
+Resources &Resources::getInstance() {
+  static Resources instance;
+  return instance;
+}
+
+BufferHandle Resources::createBuffer() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Buffers.create();
+}
+
+VertexArrayHandle Resources::createVertexArray() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return VertexArrays.create();
+}
+
+ProgramHandle Resources::createProgram() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Programs.create();
+}
+
+TextureHandle Resources::createTexture() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Textures.create();
+}
+
+void Resources::destroy(const BufferHandle handle) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  Buffers.destroy(handle, Frame + Latency);
+}
+
+void Resources::destroy(const VertexArrayHandle handle) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  VertexArrays.destroy(handle, Frame + Latency);
+}
+
+void Resources::destroy(const ProgramHandle handle) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  Programs.destroy(handle, Frame + Latency);
+}
+
+void Resources::destroy(const TextureHandle handle) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  Textures.destroy(handle, Frame + Latency);
+}
+
+GLuint Resources::get(const BufferHandle handle) const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Buffers.get(handle);
+}
+
+GLuint Resources::get(const VertexArrayHandle handle) const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return VertexArrays.get(handle);
+}
+
+GLuint Resources::get(const ProgramHandle handle) const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Programs.get(handle);
+}
+
+GLuint Resources::get(const TextureHandle handle) const {
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Textures.get(handle);
+}
+
+void Resources::collect(const uint64_t retired) {
+  Buffers.collect(retired);
+  VertexArrays.collect(retired);
+  Programs.collect(retired);
+  Textures.collect(retired);
+}
+
+void Resources::setLatency(const unsigned frames) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  Latency = frames;
+}
+
+void Resources::newFrame() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (Buffers.pending() || VertexArrays.pending() || Programs.pending() ||
+      Textures.pending()) {
+    Fences.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), Frame});
+  }
+  uint64_t retired = 0;
+  bool signalled = false;
+  while (!Fences.empty()) {
+    const GLenum result = glClientWaitSync(Fences.front().sync, 0, 0);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+      break;
+    }
+    retired = Fences.front().frame;
+    signalled = true;
+    glDeleteSync(Fences.front().sync);
+    Fences.pop_front();
+  }
+  if (signalled) {
+    collect(retired);
+  }
+  Frame++;
+}
+
+void Resources::flush() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  glFinish();
+  for (Fence &fence : Fences) {
+    glDeleteSync(fence.sync);
+  }
+  Fences.clear();
+  collect(std::numeric_limits<uint64_t>::max());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Generational Resource Pools
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_RESOURCES_HPP
+#define MGL_RESOURCES_HPP
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace mgl {
+
+template <typename Traits> struct Handle;
+template <typename Traits> class ResourcePool;
+class Resources;
+
+///////////////////////////////////////////////////////////////////////// Traits
+
+struct BufferTraits {
+  static const char *name() { return "Buffer"; }
+  static GLuint create();
+  static void destroy(const GLuint id);
+};
+
+struct VertexArrayTraits {
+  static const char *name() { return "VertexArray"; }
+  static GLuint create();
+  static void destroy(const GLuint id);
+};
+
+struct ProgramTraits {
+  static const char *name() { return "Program"; }
+  static GLuint create();
+  static void destroy(const GLuint id);
+};
+
+struct TextureTraits {
+  static const char *name() { return "Texture"; }
+  static GLuint create();
+  static void destroy(const GLuint id);
+};
+
+///////////////////////////////////////////////////////////////////////// Handle
+
+template <typename Traits> struct Handle {
+  GLuint index;
+  GLuint generation;
+
+  Handle() : index(0), generation(0) {}
+  Handle(const GLuint i, const GLuint g) : index(i), generation(g) {}
+  bool isNull() const { return generation == 0; }
+  bool operator==(const Handle &other) const {
+    return index == other.index && generation == other.generation;
+  }
+  bool operator!=(const Handle &other) const { return !(*this == other); }
+};
+
+typedef Handle<BufferTraits> BufferHandle;
+typedef Handle<VertexArrayTraits> VertexArrayHandle;
+typedef Handle<ProgramTraits> ProgramHandle;
+typedef Handle<TextureTraits> TextureHandle;
+
+/////////////////////////////////////////////////////////////////// ResourcePool
+
+template <typename Traits> class ResourcePool final {
+public:
+  ResourcePool() {}
+  ~ResourcePool() {}
+
+  ResourcePool(const ResourcePool &) = delete;
+  ResourcePool &operator=(const ResourcePool &) = delete;
+
+  Handle<Traits> create();
+  Handle<Traits> adopt(const GLuint id);
+  void destroy(const Handle<Traits> handle, const uint64_t frame);
+  bool isAlive(const Handle<Traits> handle) const;
+  GLuint get(const Handle<Traits> handle) const;
+  void collect(const uint64_t retired);
+  size_t size() const;
+  size_t pending() const;
+
+private:
+  struct Slot {
+    GLuint id;
+    GLuint generation;
+  };
+  struct Deletion {
+    GLuint id;
+    uint64_t frame;
+  };
+  std::vector<Slot> Slots;
+  std::vector<GLuint> FreeList;
+  std::deque<Deletion> Pending;
+};
+
+// Slots are stored densely and recycled through a free list. A slot's
+// generation is odd while it holds a live object and is bumped on create and
+// on destroy, so a handle to a destroyed object never matches its slot again
+// (until the 32-bit counter wraps). The GL object itself is only deleted by
+// collect() once the GPU has retired the frame in which it was destroyed.
+
+template <typename Traits> Handle<Traits> ResourcePool<Traits>::create() {
+  return adopt(Traits::create());
+}
+
+template <typename Traits>
+Handle<Traits> ResourcePool<Traits>::adopt(const GLuint id) {
+  GLuint index;
+  if (FreeList.empty()) {
+    index = static_cast<GLuint>(Slots.size());
+    Slots.push_back({0, 0});
+  } else {
+    index = FreeList.back();
+    FreeList.pop_back();
+  }
+  Slot &slot = Slots[index];
+  slot.id = id;
+  slot.generation++;
+  return Handle<Traits>(index, slot.generation);
+}
+
+template <typename Traits>
+bool ResourcePool<Traits>::isAlive(const Handle<Traits> handle) const {
+  return handle.index < Slots.size() && (handle.generation & 1) &&
+         Slots[handle.index].generation == handle.generation;
+}
+
+template <typename Traits>
+GLuint ResourcePool<Traits>::get(const Handle<Traits> handle) const {
+  if (!isAlive(handle)) {
+    std::cerr << "Stale " << Traits::name() << " handle (" << handle.index
+              << ", " << handle.generation << ")." << std::endl;
+    throw std::runtime_error("Use of destroyed resource.");
+  }
+  return Slots[handle.index].id;
+}
+
+template <typename Traits>
+void ResourcePool<Traits>::destroy(const Handle<Traits> handle,
+                                   const uint64_t frame) {
+  const GLuint id = get(handle);
+  Slot &slot = Slots[handle.index];
+  slot.generation++;
+  slot.id = 0;
+  FreeList.push_back(handle.index);
+  Pending.push_back({id, frame});
+}
+
+template <typename Traits>
+void ResourcePool<Traits>::collect(const uint64_t retired) {
+  while (!Pending.empty() && Pending.front().frame <= retired) {
+    Traits::destroy(Pending.front().id);
+    Pending.pop_front();
+  }
+}
+
+template <typename Traits> size_t ResourcePool<Traits>::size() const {
+  return Slots.size() - FreeList.size();
+}
+
+template <typename Traits> size_t ResourcePool<Traits>::pending() const {
+  return Pending.size();
+}
+
+////////////////////////////////////////////////////////////////////// Resources
+
+class Resources {
+public:
+  static Resources &getInstance();
+
+  BufferHandle createBuffer();
+  VertexArrayHandle createVertexArray();
+  ProgramHandle createProgram();
+  TextureHandle createTexture();
+
+  void destroy(const BufferHandle handle);
+  void destroy(const VertexArrayHandle handle);
+  void destroy(const ProgramHandle handle);
+  void destroy(const TextureHandle handle);
+
+  GLuint get(const BufferHandle handle) const;
+  GLuint get(const VertexArrayHandle handle) const;
+  GLuint get(const ProgramHandle handle) const;
+  GLuint get(const TextureHandle handle) const;
+
+  ResourcePool<BufferTraits> Buffers;
+  ResourcePool<VertexArrayTraits> VertexArrays;
+  ResourcePool<ProgramTraits> Programs;
+  ResourcePool<TextureTraits> Textures;
+
+  void setLatency(const unsigned frames);
+  void newFrame();
+  void flush();
+
+private:
+  Resources();
+  ~Resources();
+
+  struct Fence {
+    GLsync sync;
+    uint64_t frame;
+  };
+  std::deque<Fence> Fences;
+  uint64_t Frame;
+  unsigned Latency;
+  mutable std::mutex Mutex;
+
+  void collect(const uint64_t retired);
+
+public:
+  Resources(Resources const &) = delete;
+  void operator=(Resources const &) = delete;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_RESOURCES_HPP */
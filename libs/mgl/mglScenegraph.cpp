@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Scene Graph
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglScenegraph.hpp"
+
+#include <stdexcept>
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////// SceneGraph
+
+// Nodes are plain ids into parallel arrays holding the hierarchy. Local
+// matrices, their dirty flags and the world matrices live in arrays kept in
+// depth-first order, so a parent is always stored before its children and
+// update() is a single linear sweep over contiguous data: a node is
+// recomputed only if its local matrix changed or its parent was recomputed
+// in the same pass. The order is rebuilt only when the hierarchy itself
+// changes, carrying over the locals and world matrices of nodes that only
+// moved; reparented and new nodes are marked dirty, so only their subtrees
+// are recomputed. Until then, the local matrix of a node created since the
+// last update() is staged by id. World matrices are valid after update().
+// Using a destroyed node is an error.
+
+const SceneGraph::NodeId SceneGraph::NONE;
+
+SceneGraph::SceneGraph() : TopologyDirty(false), Updated(0) {}
+
+SceneGraph::~SceneGraph() {}
+
+SceneGraph::NodeId SceneGraph::createNode(const NodeId parent) {
+  NodeId node;
+  if (!FreeIds.empty()) {
+    node = FreeIds.back();
+    FreeIds.pop_back();
+    Parents[node] = NONE;
+    Children[node].clear();
+    Alive[node] = 1;
+    Position[node] = NONE;
+    Staged[node] = glm::mat4(1.0f);
+  } else {
+    node = static_cast<NodeId>(Parents.size());
+    Parents.push_back(NONE);
+    Children.emplace_back();
+    Alive.push_back(1);
+    Position.push_back(NONE);
+    Staged.push_back(glm::mat4(1.0f));
+  }
+  TopologyDirty = true;
+  setParent(node, parent);
+  return node;
+}
+
+void SceneGraph::detach(const NodeId node) {
+  const NodeId parent = Parents[node];
+  if (parent != NONE) {
+    std::vector<NodeId> &siblings = Children[parent];
+    for (size_t i = 0; i < siblings.size(); ++i) {
+      if (siblings[i] == node) {
+        siblings.erase(siblings.begin() + i);
+        break;
+      }
+    }
+  }
+  Parents[node] = NONE;
+}
+
+void SceneGraph::check(const NodeId node) const {
+  if (node >= Alive.size() || !Alive[node]) {
+    throw std::runtime_error("Scene graph node does not exist.");
+  }
+}
+
+void SceneGraph::destroyNode(const NodeId node) {
+  check(node);
+  std::vector<NodeId> stack(1, node);
+  detach(node);
+  while (!stack.empty()) {
+    const NodeId n = stack.back();
+    stack.pop_back();
+    for (NodeId child : Children[n]) {
+      stack.push_back(child);
+    }
+    Children[n].clear();
+    Parents[n] = NONE;
+    Alive[n] = 0;
+    Position[n] = NONE;
+    FreeIds.push_back(n);
+  }
+  TopologyDirty = true;
+}
+
+void SceneGraph::setParent(const NodeId node, const NodeId parent) {
+  check(node);
+  if (parent != NONE) {
+    check(parent);
+  }
+  for (NodeId p = parent; p != NONE; p = Parents[p]) {
+    if (p == node) {
+      throw std::runtime_error("Scene graph node cannot parent itself.");
+    }
+  }
+  detach(node);
+  Parents[node] = parent;
+  if (parent != NONE) {
+    Children[parent].push_back(node);
+  }
+  if (Position[node] != NONE) {
+    LocalDirty[Position[node]] = 1;
+  }
+  TopologyDirty = true;
+}
+
+SceneGraph::NodeId SceneGraph::getParent(const NodeId node) const {
+  check(node);
+  return Parents[node];
+}
+
+void SceneGraph::setLocalMatrix(const NodeId node, const glm::mat4 &matrix) {
+  check(node);
+  const uint32_t position = Position[node];
+  if (position == NONE) {
+    Staged[node] = matrix;
+  } else {
+    Locals[position] = matrix;
+    LocalDirty[position] = 1;
+  }
+}
+
+const glm::mat4 &SceneGraph::getLocalMatrix(const NodeId node) const {
+  check(node);
+  const uint32_t position = Position[node];
+  return position == NONE ? Staged[node] : Locals[position];
+}
+
+const glm::mat4 &SceneGraph::getWorldMatrix(const NodeId node) const {
+  check(node);
+  if (Position[node] == NONE) {
+    throw std::runtime_error("Scene graph node has not been updated.");
+  }
+  return Worlds[Position[node]];
+}
+
+void SceneGraph::rebuild() {
+  const std::vector<uint32_t> old_position = Position;
+  std::vector<glm::mat4> old_locals, old_worlds;
+  std::vector<uint8_t> old_dirty;
+  old_locals.swap(Locals);
+  old_worlds.swap(Worlds);
+  old_dirty.swap(LocalDirty);
+  Order.clear();
+  OrderParent.clear();
+  std::vector<NodeId> stack;
+  for (NodeId root = 0; root < Parents.size(); ++root) {
+    if (!Alive[root] || Parents[root] != NONE) {
+      continue;
+    }
+    stack.push_back(root);
+    while (!stack.empty()) {
+      const NodeId n = stack.back();
+      stack.pop_back();
+      Position[n] = static_cast<uint32_t>(Order.size());
+      Order.push_back(n);
+      OrderParent.push_back(Parents[n] == NONE ? NONE : Position[Parents[n]]);
+      for (auto i = Children[n].rbegin(); i != Children[n].rend(); ++i) {
+        stack.push_back(*i);
+      }
+    }
+  }
+  const size_t count = Order.size();
+  Locals.resize(count);
+  LocalDirty.resize(count);
+  Worlds.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const NodeId n = Order[i];
+    const uint32_t old = old_position[n];
+    if (old == NONE) {
+      Locals[i] = Staged[n];
+      LocalDirty[i] = 1;
+    } else {
+      Locals[i] = old_locals[old];
+      LocalDirty[i] = old_dirty[old];
+      if (!LocalDirty[i]) {
+        Worlds[i] = old_worlds[old];
+      }
+    }
+  }
+  WorldDirty.assign(count, 0);
+  TopologyDirty = false;
+}
+
+void SceneGraph::update() {
+  if (TopologyDirty) {
+    rebuild();
+  }
+  Updated = 0;
+  const size_t n = OrderParent.size();
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t parent = OrderParent[i];
+    const bool dirty = LocalDirty[i] || (parent != NONE && WorldDirty[parent]);
+    WorldDirty[i] = dirty;
+    if (dirty) {
+      Worlds[i] = parent == NONE ? Locals[i] : Worlds[parent] * Locals[i];
+      LocalDirty[i] = 0;
+      Updated++;
+    }
+  }
+}
+
+size_t SceneGraph::size() const { return Parents.size() - FreeIds.size(); }
+
+size_t SceneGraph::getUpdatedCount() const { return Updated; }
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Scene Graph
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_SCENEGRAPH_HPP
+#define MGL_SCENEGRAPH_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mgl {
+
+class SceneGraph;
+
+///////////////////////////////////////////////////////////////////// SceneGraph
+
+class SceneGraph final {
+public:
+  typedef uint32_t NodeId;
+  static const NodeId NONE = 0xFFFFFFFF;
+
+  SceneGraph();
+  ~SceneGraph();
+
+  NodeId createNode(const NodeId parent = NONE);
+  void destroyNode(const NodeId node);
+  void setParent(const NodeId node, const NodeId parent);
+  NodeId getParent(const NodeId node) const;
+  void setLocalMatrix(const NodeId node, const glm::mat4 &matrix);
+  const glm::mat4 &getLocalMatrix(const NodeId node) const;
+  const glm::mat4 &getWorldMatrix(const NodeId node) const;
+  void update();
+  size_t size() const;
+  size_t getUpdatedCount() const;
+
+private:
+  // Indexed by NodeId.
+  std::vector<NodeId> Parents;
+  std::vector<std::vector<NodeId>> Children;
+  std::vector<uint8_t> Alive;
+  std::vector<uint32_t> Position;
+  std::vector<glm::mat4> Staged;
+  std::vector<NodeId> FreeIds;
+
+  // Depth-first order, parents always before their children.
+  std::vector<NodeId> Order;
+  std::vector<uint32_t> OrderParent;
+  std::vector<glm::mat4> Locals;
+  std::vector<uint8_t> LocalDirty;
+  std::vector<glm::mat4> Worlds;
+  std::vector<uint8_t> WorldDirty;
+
+  bool TopologyDirty;
+  size_t Updated;
+
+  void rebuild();
+  void detach(const NodeId node);
+  void check(const NodeId node) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_SCENEGRAPH_HPP */
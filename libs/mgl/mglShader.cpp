@@ -8,10 +8,19 @@
 
 #include "./mglShader.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <glm/gtc/type_ptr.hpp>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 
+#include "./mglState.hpp"
+
 namespace mgl {
 
 ////////////////////////////////////////////////////////////////// ShaderProgram
@@ -56,87 +65,374 @@ void ShaderProgram::checkLinkage() {
   }
 }
 
-ShaderProgram::ShaderProgram() : ProgramId(glCreateProgram()) {}
+// The program object is owned by Resources, so its deletion is deferred
+// until the GPU has retired the frame in which the ShaderProgram died, and
+// the StateCache forgets it then. Destruction issues no GL calls and may
+// happen on any thread.
 
-ShaderProgram::~ShaderProgram() {
-  glUseProgram(0);
-  glDeleteProgram(ProgramId);
+ShaderProgram::ShaderProgram()
+    : Handle(Resources::getInstance().createProgram()), State(IDLE),
+      Cached(false) {
+  ProgramId = Resources::getInstance().get(Handle);
 }
 
-void ShaderProgram::addShader(const GLenum shader_type,
-                              const std::string &filename) {
+ShaderProgram::~ShaderProgram() { Resources::getInstance().destroy(Handle); }
+
+void ShaderProgram::compile(const GLenum shader_type,
+                            const SourceInfo &source) {
   const GLuint shader_id = glCreateShader(shader_type);
-  const std::string scode = read(filename);
-  const GLchar *code = scode.c_str();
+  const GLchar *code = source.code.c_str();
   glShaderSource(shader_id, 1, &code, 0);
   glCompileShader(shader_id);
-  checkCompilation(shader_id, filename);
   glAttachShader(ProgramId, shader_id);
 
   Shaders[shader_type] = {shader_id};
 }
 
+void ShaderProgram::addShader(const GLenum shader_type,
+                              const std::string &filename) {
+  Sources[shader_type] = {filename, read(filename)};
+  if (CacheDirectory.empty()) {
+    compile(shader_type, Sources[shader_type]);
+  }
+}
+
+// Attributes, uniforms and uniform blocks live in flat vectors searched by
+// the hash of their name. Lookups only happen at setup time; per-draw code
+// keeps the UniformHandle returned by addUniform() or getUniform(), which is
+// a plain index into Uniforms.
+
+template <typename T>
+static int find(const std::vector<T> &v, const std::string &name) {
+  const GLuint hash = hashName(name.c_str());
+  for (size_t i = 0; i < v.size(); ++i) {
+    if (v[i].hash == hash) {
+      if (v[i].name != name) {
+        std::cerr << "[ERROR] Name hash collision: " << name << " and "
+                  << v[i].name << std::endl;
+        throw std::runtime_error("Shader variable name hash collision.");
+      }
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
 void ShaderProgram::addAttribute(const std::string &name, const GLuint index) {
-  if (isAttribute(name)) {
+  const AttributeInfo info = {name, hashName(name.c_str()), index};
+  const int i = find(Attributes, name);
+  if (i >= 0) {
     std::cerr << "[WARNING] Attribute " << name << " already exists"
               << std::endl;
+    Attributes[i] = info;
+  } else {
+    Attributes.push_back(info);
   }
   glBindAttribLocation(ProgramId, index, name.c_str());
-  Attributes[name] = {index};
 }
 
 bool ShaderProgram::isAttribute(const std::string &name) {
-  return Attributes.find(name) != Attributes.end();
+  return find(Attributes, name) >= 0;
 }
 
-void ShaderProgram::addUniform(const std::string &name) {
-  if (isUniform(name)) {
+ShaderProgram::UniformHandle
+ShaderProgram::addUniform(const std::string &name) {
+  const UniformInfo info = {name, hashName(name.c_str()), -1, false, {}};
+  const int i = find(Uniforms, name);
+  if (i >= 0) {
     std::cerr << "[WARNING] Uniform " << name << " already exists" << std::endl;
+    Uniforms[i] = info;
+    return static_cast<UniformHandle>(i);
   }
-  Uniforms[name] = {-1};
+  Uniforms.push_back(info);
+  return static_cast<UniformHandle>(Uniforms.size() - 1);
 }
 
 bool ShaderProgram::isUniform(const std::string &name) {
-  return Uniforms.find(name) != Uniforms.end();
+  return find(Uniforms, name) >= 0;
+}
+
+ShaderProgram::UniformHandle ShaderProgram::getUniform(const GLuint hash) {
+  for (size_t i = 0; i < Uniforms.size(); ++i) {
+    if (Uniforms[i].hash == hash) {
+      return static_cast<UniformHandle>(i);
+    }
+  }
+  throw std::runtime_error("Uniform not registered.");
 }
 
 void ShaderProgram::addUniformBlock(const std::string &name,
                                     const GLuint binding_point) {
-  if (isUniformBlock(name)) {
+  const UboInfo info = {name, hashName(name.c_str()), 0, binding_point};
+  const int i = find(Ubos, name);
+  if (i >= 0) {
     std::cerr << "[WARNING] Uniform block " << name << " already exists"
               << std::endl;
+    Ubos[i] = info;
+  } else {
+    Ubos.push_back(info);
   }
-  Ubos[name] = {0, binding_point};
 }
 
 bool ShaderProgram::isUniformBlock(const std::string &name) {
-  return Ubos.find(name) != Ubos.end();
+  return find(Ubos, name) >= 0;
 }
 
-void ShaderProgram::create() {
+// Compilation and linkage are only submitted here; their status is checked
+// in finish(), so with KHR_parallel_shader_compile the driver can work on
+// every program in the background until isReady() sees it completed.
+void ShaderProgram::submit() {
+  Cached = false;
+  if (!CacheDirectory.empty()) {
+    CacheFile = cacheFilename();
+    if (loadBinary(CacheFile)) {
+      Cached = true;
+      State = LINKING;
+      return;
+    }
+    for (auto &i : Sources) {
+      compile(i.first, i.second);
+    }
+    glProgramParameteri(ProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                        GL_TRUE);
+  }
   glLinkProgram(ProgramId);
+  State = LINKING;
+}
+
+void ShaderProgram::finish() {
+  for (auto &i : Shaders) {
+    checkCompilation(i.second, Sources[i.first].filename);
+  }
   checkLinkage();
+  if (!CacheDirectory.empty() && !Cached) {
+    saveBinary(CacheFile);
+  }
   for (auto &i : Shaders) {
     glDetachShader(ProgramId, i.second);
     glDeleteShader(i.second);
   }
+  Sources.clear();
 
   for (auto &i : Uniforms) {
-    i.second.index = glGetUniformLocation(ProgramId, i.first.c_str());
-    if (i.second.index < 0)
-      std::cerr << "WARNING: Uniform " << i.first << " not found." << std::endl;
+    i.index = glGetUniformLocation(ProgramId, i.name.c_str());
+    i.cached = false;
+    if (i.index < 0)
+      std::cerr << "WARNING: Uniform " << i.name << " not found." << std::endl;
   }
   for (auto &i : Ubos) {
-    i.second.index = glGetUniformBlockIndex(ProgramId, i.first.c_str());
-    if (i.second.index == GL_INVALID_INDEX)
-      std::cerr << "WARNING: UBO " << i.first << " not found." << std::endl;
-    glUniformBlockBinding(ProgramId, i.second.index, i.second.binding_point);
+    i.index = glGetUniformBlockIndex(ProgramId, i.name.c_str());
+    if (i.index == GL_INVALID_INDEX)
+      std::cerr << "WARNING: UBO " << i.name << " not found." << std::endl;
+    glUniformBlockBinding(ProgramId, i.index, i.binding_point);
+  }
+
+  // Active uniforms that were not registered become available by hash too.
+  Layout.reflect(ProgramId);
+  for (auto &i : Layout.Uniforms) {
+    if (i.block < 0 && i.location >= 0 && !isUniform(i.name)) {
+      Uniforms.push_back({i.name, i.hash, i.location, false, {}});
+    }
+  }
+  State = READY;
+}
+
+void ShaderProgram::create() {
+  submit();
+  finish();
+}
+
+void ShaderProgram::createAsync() { submit(); }
+
+// Without parallel compile support the driver cannot report progress, so the
+// first poll blocks until the program is linked.
+bool ShaderProgram::isReady() {
+  if (State != LINKING) {
+    return State == READY;
+  }
+  if (GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) {
+    GLint completed = GL_FALSE;
+    glGetProgramiv(ProgramId, GL_COMPLETION_STATUS_KHR, &completed);
+    if (completed == GL_FALSE) {
+      return false;
+    }
+  }
+  finish();
+  return true;
+}
+
+void ShaderProgram::bind() { StateCache::getInstance().useProgram(ProgramId); }
+
+void ShaderProgram::unbind() { StateCache::getInstance().useProgram(0); }
+
+/////////////////////////////////////////////////////////////////// BINARY CACHE
+
+// When a cache directory is set, sources are only read by addShader() and
+// create() first tries to restore the linked program from a binary saved by a
+// previous run. The file is keyed by a hash of the sources, the attribute
+// bindings and the driver strings, and is discarded if the driver rejects it,
+// in which case the program is compiled and linked from source as usual.
+
+std::string ShaderProgram::CacheDirectory;
+
+static const char CACHE_MAGIC[4] = {'M', 'G', 'L', 'B'};
+
+static uint64_t fnv1a(uint64_t hash, const std::string &data) {
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ull;
   }
+  return hash;
 }
 
-void ShaderProgram::bind() { glUseProgram(ProgramId); }
+void ShaderProgram::setCacheDirectory(const std::string &directory) {
+  CacheDirectory = directory;
+}
+
+const std::string ShaderProgram::cacheFilename() {
+  uint64_t hash = 14695981039346656037ull;
+  hash = fnv1a(hash, reinterpret_cast<const char *>(glGetString(GL_VENDOR)));
+  hash = fnv1a(hash, reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+  hash = fnv1a(hash, reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+  for (auto &i : Sources) {
+    hash = fnv1a(hash, std::to_string(i.first));
+    hash = fnv1a(hash, i.second.code);
+  }
+  for (auto &i : Attributes) {
+    hash = fnv1a(hash, i.name + "=" + std::to_string(i.index));
+  }
+  std::ostringstream name;
+  name << CacheDirectory << "/" << std::hex << std::setw(16)
+       << std::setfill('0') << hash << ".bin";
+  return name.str();
+}
+
+bool ShaderProgram::loadBinary(const std::string &filename) {
+  std::ifstream ifile(filename, std::ios::binary);
+  if (!ifile.is_open()) {
+    return false;
+  }
+  char magic[4];
+  GLenum format;
+  std::vector<char> binary;
+  ifile.read(magic, sizeof(magic));
+  ifile.read(reinterpret_cast<char *>(&format), sizeof(format));
+  if (!ifile || !std::equal(magic, magic + 4, CACHE_MAGIC)) {
+    return false;
+  }
+  binary.assign(std::istreambuf_iterator<char>(ifile),
+                std::istreambuf_iterator<char>());
+  if (binary.empty()) {
+    return false;
+  }
+  glProgramBinary(ProgramId, format, binary.data(),
+                  static_cast<GLsizei>(binary.size()));
+  GLint linked;
+  glGetProgramiv(ProgramId, GL_LINK_STATUS, &linked);
+  return linked == GL_TRUE;
+}
+
+void ShaderProgram::saveBinary(const std::string &filename) {
+  GLint length = 0;
+  glGetProgramiv(ProgramId, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format;
+  glGetProgramBinary(ProgramId, length, &length, &format, binary.data());
+  std::ofstream ofile(filename, std::ios::binary);
+  if (!ofile.is_open()) {
+    std::cerr << "[WARNING] Failed to write program cache: " << filename
+              << std::endl;
+    return;
+  }
+  ofile.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  ofile.write(reinterpret_cast<const char *>(&format), sizeof(format));
+  ofile.write(binary.data(), length);
+}
+
+/////////////////////////////////////////////////////////////////////// UNIFORMS
+
+// The typed setters keep a shadow copy of the last value uploaded to each
+// uniform and skip the glUniform call when it has not changed. The program
+// must be bound. Upload counts are kept per frame; getUniformStats() reports
+// the last complete frame, as closed by newFrame().
+
+ShaderProgram::UniformStats ShaderProgram::FrameStats = {0, 0};
+ShaderProgram::UniformStats ShaderProgram::LastFrameStats = {0, 0};
 
-void ShaderProgram::unbind() { glUseProgram(0); }
+GLint ShaderProgram::update(const UniformHandle handle, const void *value,
+                            const size_t size) {
+  UniformInfo &info = Uniforms[handle];
+  if (info.index < 0) {
+    return -1;
+  }
+  if (info.cached && std::memcmp(info.value, value, size) == 0) {
+    FrameStats.elided++;
+    return -1;
+  }
+  std::memcpy(info.value, value, size);
+  info.cached = true;
+  FrameStats.uploads++;
+  return info.index;
+}
+
+void ShaderProgram::setMat4(const UniformHandle handle,
+                            const glm::mat4 &value) {
+  const GLint index = update(handle, glm::value_ptr(value), sizeof(value));
+  if (index >= 0)
+    glUniformMatrix4fv(index, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::setMat3(const UniformHandle handle,
+                            const glm::mat3 &value) {
+  const GLint index = update(handle, glm::value_ptr(value), sizeof(value));
+  if (index >= 0)
+    glUniformMatrix3fv(index, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec4(const UniformHandle handle,
+                            const glm::vec4 &value) {
+  const GLint index = update(handle, glm::value_ptr(value), sizeof(value));
+  if (index >= 0)
+    glUniform4fv(index, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec3(const UniformHandle handle,
+                            const glm::vec3 &value) {
+  const GLint index = update(handle, glm::value_ptr(value), sizeof(value));
+  if (index >= 0)
+    glUniform3fv(index, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setVec2(const UniformHandle handle,
+                            const glm::vec2 &value) {
+  const GLint index = update(handle, glm::value_ptr(value), sizeof(value));
+  if (index >= 0)
+    glUniform2fv(index, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::setFloat(const UniformHandle handle, const GLfloat value) {
+  const GLint index = update(handle, &value, sizeof(value));
+  if (index >= 0)
+    glUniform1f(index, value);
+}
+
+void ShaderProgram::setInt(const UniformHandle handle, const GLint value) {
+  const GLint index = update(handle, &value, sizeof(value));
+  if (index >= 0)
+    glUniform1i(index, value);
+}
+
+ShaderProgram::UniformStats ShaderProgram::getUniformStats() {
+  return LastFrameStats;
+}
+
+void ShaderProgram::newFrame() {
+  LastFrameStats = FrameStats;
+  FrameStats = {0, 0};
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 } // namespace mgl
@@ -10,9 +10,15 @@
 #define MGL_SHADER_HPP
 
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 
 #include <map>
 #include <string>
+#include <vector>
+
+#include "./mglConventions.hpp"
+#include "./mglLayout.hpp"
+#include "./mglResources.hpp"
 
 namespace mgl {
 
@@ -29,21 +35,33 @@ public:
   };
   std::map<GLenum, GLuint> Shaders;
 
+  typedef GLuint UniformHandle;
+
   struct AttributeInfo {
+    std::string name;
+    GLuint hash;
     GLuint index;
   };
-  std::map<std::string, AttributeInfo> Attributes;
+  std::vector<AttributeInfo> Attributes;
 
   struct UniformInfo {
+    std::string name;
+    GLuint hash;
     GLint index;
+    bool cached;
+    GLfloat value[16];
   };
-  std::map<std::string, UniformInfo> Uniforms;
+  std::vector<UniformInfo> Uniforms;
 
   struct UboInfo {
+    std::string name;
+    GLuint hash;
     GLuint index;
     GLuint binding_point;
   };
-  std::map<std::string, UboInfo> Ubos;
+  std::vector<UboInfo> Ubos;
+
+  ProgramLayout Layout;
 
   ShaderProgram();
   ~ShaderProgram();
@@ -56,18 +74,62 @@ public:
   void addShader(const GLenum shader_type, const std::string &filename);
   void addAttribute(const std::string &name, const GLuint index);
   bool isAttribute(const std::string &name);
-  void addUniform(const std::string &name);
+  UniformHandle addUniform(const std::string &name);
   bool isUniform(const std::string &name);
+  UniformHandle getUniform(const GLuint hash);
   void addUniformBlock(const std::string &name, const GLuint binding_point);
   bool isUniformBlock(const std::string &name);
   void create();
+  void createAsync();
+  bool isReady();
   void bind();
   void unbind();
 
+  void setMat4(const UniformHandle handle, const glm::mat4 &value);
+  void setMat3(const UniformHandle handle, const glm::mat3 &value);
+  void setVec4(const UniformHandle handle, const glm::vec4 &value);
+  void setVec3(const UniformHandle handle, const glm::vec3 &value);
+  void setVec2(const UniformHandle handle, const glm::vec2 &value);
+  void setFloat(const UniformHandle handle, const GLfloat value);
+  void setInt(const UniformHandle handle, const GLint value);
+
+  struct UniformStats {
+    unsigned uploads;
+    unsigned elided;
+  };
+  static UniformStats getUniformStats();
+  static void newFrame();
+
+  static void setCacheDirectory(const std::string &directory);
+
 private:
+  static std::string CacheDirectory;
+  static UniformStats FrameStats, LastFrameStats;
+
+  ProgramHandle Handle;
+
+  enum BuildState { IDLE, LINKING, READY };
+  BuildState State;
+  bool Cached;
+  std::string CacheFile;
+
+  struct SourceInfo {
+    std::string filename;
+    std::string code;
+  };
+  std::map<GLenum, SourceInfo> Sources;
+
   const std::string read(const std::string &filename);
+  void compile(const GLenum shader_type, const SourceInfo &source);
   void checkCompilation(const GLuint shader_id, const std::string &filename);
   void checkLinkage();
+  void submit();
+  void finish();
+  GLint update(const UniformHandle handle, const void *value,
+               const size_t size);
+  const std::string cacheFilename();
+  bool loadBinary(const std::string &filename);
+  void saveBinary(const std::string &filename);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
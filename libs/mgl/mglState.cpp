@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// OpenGL State Cache
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////////// StateCache
+
+// Shadows the bindings and fixed-function state most often set per draw and
+// only forwards a call to OpenGL when the value actually changes. Anything
+// set behind its back must be reported with invalidate(), or with one of the
+// forget*() methods when an object that may be bound is deleted. The element
+// array buffer belongs to the VAO, so it is forgotten whenever the VAO
+// changes. Targets and capabilities it does not track are always issued.
+// Indexed buffer bindings are not shadowed and are always issued, but they
+// also bind the generic target, so they must go through bindBufferBase() or
+// bindBufferRange() to keep that binding known.
+
+const GLuint StateCache::UNKNOWN;
+
+static int bufferSlot(const GLenum target) {
+  switch (target) {
+  case GL_ARRAY_BUFFER:
+    return 0;
+  case GL_ELEMENT_ARRAY_BUFFER:
+    return 1;
+  case GL_UNIFORM_BUFFER:
+    return 2;
+  case GL_SHADER_STORAGE_BUFFER:
+    return 3;
+  case GL_DRAW_INDIRECT_BUFFER:
+    return 4;
+  case GL_COPY_READ_BUFFER:
+    return 5;
+  case GL_COPY_WRITE_BUFFER:
+    return 6;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return 7;
+  default:
+    return -1;
+  }
+}
+
+static int textureSlot(const GLenum target) {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_3D:
+    return 1;
+  case GL_TEXTURE_CUBE_MAP:
+    return 2;
+  case GL_TEXTURE_2D_ARRAY:
+    return 3;
+  case GL_TEXTURE_BUFFER:
+    return 4;
+  default:
+    return -1;
+  }
+}
+
+static int capabilitySlot(const GLenum cap) {
+  switch (cap) {
+  case GL_BLEND:
+    return 0;
+  case GL_DEPTH_TEST:
+    return 1;
+  case GL_CULL_FACE:
+    return 2;
+  case GL_SCISSOR_TEST:
+    return 3;
+  case GL_STENCIL_TEST:
+    return 4;
+  case GL_MULTISAMPLE:
+    return 5;
+  case GL_POLYGON_OFFSET_FILL:
+    return 6;
+  case GL_PROGRAM_POINT_SIZE:
+    return 7;
+  default:
+    return -1;
+  }
+}
+
+StateCache::StateCache() : FrameStats{0, 0}, LastFrameStats{0, 0} {
+  invalidate();
+}
+
+StateCache::~StateCache() {}
+
+StateCache &StateCache::getInstance() {
+  static StateCache instance;
+  return instance;
+}
+
+// Direct state access (OpenGL 4.5 or ARB_direct_state_access) edits objects
+// by name without binding them, leaving the cached bindings untouched.
+bool StateCache::hasDirectStateAccess() {
+  return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+}
+
+void StateCache::invalidate() {
+  Program = UNKNOWN;
+  VertexArray = UNKNOWN;
+  for (GLuint &buffer : Buffers) {
+    buffer = UNKNOWN;
+  }
+  ActiveUnit = UNKNOWN;
+  for (auto &unit : Textures) {
+    for (GLuint &texture : unit) {
+      texture = UNKNOWN;
+    }
+  }
+  for (GLint &cap : Capabilities) {
+    cap = -1;
+  }
+  BlendSrc = BlendDst = UNKNOWN;
+  DepthFunc = UNKNOWN;
+  DepthMask = -1;
+  CullFace = UNKNOWN;
+  FrontFace = UNKNOWN;
+}
+
+bool StateCache::changed(GLuint &cached, const GLuint value) {
+  if (cached == value) {
+    FrameStats.elided++;
+    return false;
+  }
+  cached = value;
+  FrameStats.issued++;
+  return true;
+}
+
+void StateCache::useProgram(const GLuint program) {
+  if (changed(Program, program))
+    glUseProgram(program);
+}
+
+void StateCache::bindVertexArray(const GLuint vao) {
+  if (changed(VertexArray, vao)) {
+    glBindVertexArray(vao);
+    Buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+  }
+}
+
+void StateCache::bindBuffer(const GLenum target, const GLuint buffer) {
+  const int slot = bufferSlot(target);
+  if (slot < 0) {
+    FrameStats.issued++;
+    glBindBuffer(target, buffer);
+  } else if (changed(Buffers[slot], buffer)) {
+    glBindBuffer(target, buffer);
+  }
+}
+
+void StateCache::bindBufferBase(const GLenum target, const GLuint index,
+                                const GLuint buffer) {
+  const int slot = bufferSlot(target);
+  if (slot >= 0) {
+    Buffers[slot] = buffer;
+  }
+  FrameStats.issued++;
+  glBindBufferBase(target, index, buffer);
+}
+
+void StateCache::bindBufferRange(const GLenum target, const GLuint index,
+                                 const GLuint buffer, const GLintptr offset,
+                                 const GLsizeiptr size) {
+  const int slot = bufferSlot(target);
+  if (slot >= 0) {
+    Buffers[slot] = buffer;
+  }
+  FrameStats.issued++;
+  glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void StateCache::bindTexture(const GLuint unit, const GLenum target,
+                             const GLuint texture) {
+  const int slot = textureSlot(target);
+  if (slot < 0 || unit >= MAX_TEXTURE_UNITS) {
+    FrameStats.issued++;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    ActiveUnit = unit;
+    glBindTexture(target, texture);
+  } else if (Textures[unit][slot] != texture) {
+    if (changed(ActiveUnit, unit))
+      glActiveTexture(GL_TEXTURE0 + unit);
+    changed(Textures[unit][slot], texture);
+    glBindTexture(target, texture);
+  } else {
+    FrameStats.elided++;
+  }
+}
+
+void StateCache::setCapability(const GLenum cap, const GLint value) {
+  const int slot = capabilitySlot(cap);
+  if (slot >= 0 && Capabilities[slot] == value) {
+    FrameStats.elided++;
+    return;
+  }
+  if (slot >= 0) {
+    Capabilities[slot] = value;
+  }
+  FrameStats.issued++;
+  if (value)
+    glEnable(cap);
+  else
+    glDisable(cap);
+}
+
+void StateCache::enable(const GLenum cap) { setCapability(cap, 1); }
+
+void StateCache::disable(const GLenum cap) { setCapability(cap, 0); }
+
+void StateCache::blendFunc(const GLenum sfactor, const GLenum dfactor) {
+  if (BlendSrc == sfactor && BlendDst == dfactor) {
+    FrameStats.elided++;
+    return;
+  }
+  BlendSrc = sfactor;
+  BlendDst = dfactor;
+  FrameStats.issued++;
+  glBlendFunc(sfactor, dfactor);
+}
+
+void StateCache::depthFunc(const GLenum func) {
+  if (changed(DepthFunc, func))
+    glDepthFunc(func);
+}
+
+void StateCache::depthMask(const GLboolean flag) {
+  if (DepthMask == flag) {
+    FrameStats.elided++;
+    return;
+  }
+  DepthMask = flag;
+  FrameStats.issued++;
+  glDepthMask(flag);
+}
+
+void StateCache::cullFace(const GLenum mode) {
+  if (changed(CullFace, mode))
+    glCullFace(mode);
+}
+
+void StateCache::frontFace(const GLenum mode) {
+  if (changed(FrontFace, mode))
+    glFrontFace(mode);
+}
+
+GLuint StateCache::getVertexArray() const { return VertexArray; }
+
+// Deleting the current program does not unbind it, so its binding becomes
+// unknown; deleted VAOs, buffers and textures revert their bindings to 0.
+
+void StateCache::forgetProgram(const GLuint program) {
+  if (Program == program)
+    Program = UNKNOWN;
+}
+
+void StateCache::forgetVertexArray(const GLuint vao) {
+  if (VertexArray == vao) {
+    VertexArray = 0;
+    Buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+  }
+}
+
+void StateCache::forgetBuffer(const GLuint buffer) {
+  for (GLuint &b : Buffers) {
+    if (b == buffer)
+      b = 0;
+  }
+}
+
+void StateCache::forgetTexture(const GLuint texture) {
+  for (auto &unit : Textures) {
+    for (GLuint &t : unit) {
+      if (t == texture)
+        t = 0;
+    }
+  }
+}
+
+StateCache::Stats StateCache::getStats() { return LastFrameStats; }
+
+void StateCache::newFrame() {
+  LastFrameStats = FrameStats;
+  FrameStats = {0, 0};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
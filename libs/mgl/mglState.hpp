@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// OpenGL State Cache
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_STATE_HPP
+#define MGL_STATE_HPP
+
+#include <GL/glew.h>
+
+namespace mgl {
+
+class StateCache;
+
+///////////////////////////////////////////////////////////////////// StateCache
+
+class StateCache {
+public:
+  static const GLuint UNKNOWN = 0xFFFFFFFF;
+  static const int MAX_TEXTURE_UNITS = 32;
+
+  struct Stats {
+    unsigned issued;
+    unsigned elided;
+  };
+
+  static StateCache &getInstance();
+  static bool hasDirectStateAccess();
+
+  void useProgram(const GLuint program);
+  void bindVertexArray(const GLuint vao);
+  void bindBuffer(const GLenum target, const GLuint buffer);
+  void bindBufferBase(const GLenum target, const GLuint index,
+                      const GLuint buffer);
+  void bindBufferRange(const GLenum target, const GLuint index,
+                       const GLuint buffer, const GLintptr offset,
+                       const GLsizeiptr size);
+  void bindTexture(const GLuint unit, const GLenum target,
+                   const GLuint texture);
+  void enable(const GLenum cap);
+  void disable(const GLenum cap);
+  void blendFunc(const GLenum sfactor, const GLenum dfactor);
+  void depthFunc(const GLenum func);
+  void depthMask(const GLboolean flag);
+  void cullFace(const GLenum mode);
+  void frontFace(const GLenum mode);
+
+  GLuint getVertexArray() const;
+
+  void forgetProgram(const GLuint program);
+  void forgetVertexArray(const GLuint vao);
+  void forgetBuffer(const GLuint buffer);
+  void forgetTexture(const GLuint texture);
+  void invalidate();
+
+  Stats getStats();
+  void newFrame();
+
+private:
+  StateCache();
+  ~StateCache();
+
+  static const int BUFFER_TARGETS = 8;
+  static const int TEXTURE_TARGETS = 5;
+  static const int CAPABILITIES = 8;
+
+  GLuint Program;
+  GLuint VertexArray;
+  GLuint Buffers[BUFFER_TARGETS];
+  GLuint ActiveUnit;
+  GLuint Textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+  GLint Capabilities[CAPABILITIES];
+  GLenum BlendSrc, BlendDst;
+  GLenum DepthFunc;
+  GLint DepthMask;
+  GLenum CullFace;
+  GLenum FrontFace;
+  Stats FrameStats, LastFrameStats;
+
+  bool changed(GLuint &cached, const GLuint value);
+  void setCapability(const GLenum cap, const GLint value);
+
+public:
+  StateCache(StateCache const &) = delete;
+  void operator=(StateCache const &) = delete;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_STATE_HPP */
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Persistent Mapped Stream Buffer
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglStreamBuffer.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+/////////////////////////////////////////////////////////////////// StreamBuffer
+
+// An immutable buffer (glBufferStorage, OpenGL 4.4) of REGIONS equal regions,
+// mapped once with GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT. Each frame the
+// App writes straight into the next region through allocate(), a bump
+// allocator, with no driver copies. endFrame() fences the region and
+// beginFrame() only waits on that fence when the GPU is still REGIONS frames
+// behind, which is counted as a stall.
+
+const int StreamBuffer::REGIONS;
+
+StreamBuffer::StreamBuffer(const GLenum target, const GLsizeiptr region_size)
+    : Target(target), RegionSize(region_size), Alignment(1), BufferId(0),
+      Mapped(nullptr), Fences{nullptr, nullptr, nullptr}, Region(0), Head(0),
+      Stalls(0) {}
+
+StreamBuffer::~StreamBuffer() { destroy(); }
+
+bool StreamBuffer::isSupported() {
+  return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+void StreamBuffer::create() {
+  if (!isSupported()) {
+    throw std::runtime_error("Persistent mapped buffers are not supported.");
+  }
+  GLint alignment = 1;
+  if (Target == GL_UNIFORM_BUFFER) {
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  } else if (Target == GL_SHADER_STORAGE_BUFFER) {
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  } else {
+    alignment = 16;
+  }
+  Alignment = alignment;
+  RegionSize = (RegionSize + Alignment - 1) / Alignment * Alignment;
+
+  const GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  Buffer = Resources::getInstance().createBuffer();
+  BufferId = Resources::getInstance().get(Buffer);
+  StateCache::getInstance().bindBuffer(Target, BufferId);
+  glBufferStorage(Target, RegionSize * REGIONS, nullptr, flags);
+  Mapped = static_cast<GLubyte *>(
+      glMapBufferRange(Target, 0, RegionSize * REGIONS, flags));
+  if (!Mapped) {
+    throw std::runtime_error("Failed to map stream buffer.");
+  }
+  Region = 0;
+  Head = 0;
+}
+
+void StreamBuffer::destroy() {
+  for (GLsync &fence : Fences) {
+    if (fence) {
+      glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  if (BufferId) {
+    StateCache &state = StateCache::getInstance();
+    state.bindBuffer(Target, BufferId);
+    glUnmapBuffer(Target);
+    Resources::getInstance().destroy(Buffer);
+    Buffer = BufferHandle();
+    BufferId = 0;
+    Mapped = nullptr;
+  }
+}
+
+void StreamBuffer::wait(GLsync &fence) {
+  if (!fence) {
+    return;
+  }
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    Stalls++;
+    do {
+      result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+  }
+  if (result == GL_WAIT_FAILED) {
+    std::cerr << "[WARNING] Stream buffer fence wait failed." << std::endl;
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+  Region = (Region + 1) % REGIONS;
+  Head = 0;
+  wait(Fences[Region]);
+}
+
+void StreamBuffer::endFrame() {
+  if (Fences[Region]) {
+    glDeleteSync(Fences[Region]);
+  }
+  Fences[Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(const GLsizeiptr size) {
+  const GLsizeiptr aligned = (size + Alignment - 1) / Alignment * Alignment;
+  if (Head + aligned > RegionSize) {
+    throw std::runtime_error("Stream buffer region exhausted.");
+  }
+  const GLintptr offset = Region * RegionSize + Head;
+  Head += aligned;
+  return {Mapped + offset, offset, size};
+}
+
+void StreamBuffer::bindRange(const GLuint binding_point,
+                             const Allocation &allocation) {
+  StateCache::getInstance().bindBufferRange(Target, binding_point, BufferId,
+                                            allocation.offset, allocation.size);
+}
+
+GLuint StreamBuffer::getBuffer() { return BufferId; }
+
+unsigned StreamBuffer::getStalls() { return Stalls; }
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Persistent Mapped Stream Buffer
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_STREAM_BUFFER_HPP
+#define MGL_STREAM_BUFFER_HPP
+
+#include <GL/glew.h>
+
+#include "./mglResources.hpp"
+
+namespace mgl {
+
+class StreamBuffer;
+
+/////////////////////////////////////////////////////////////////// StreamBuffer
+
+class StreamBuffer final {
+public:
+  static const int REGIONS = 3;
+
+  struct Allocation {
+    void *data;
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  StreamBuffer(const GLenum target, const GLsizeiptr region_size);
+  ~StreamBuffer();
+
+  StreamBuffer(const StreamBuffer &) = delete;
+  StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+  static bool isSupported();
+  void create();
+  void destroy();
+  void beginFrame();
+  void endFrame();
+  Allocation allocate(const GLsizeiptr size);
+  void bindRange(const GLuint binding_point, const Allocation &allocation);
+  GLuint getBuffer();
+  unsigned getStalls();
+
+private:
+  GLenum Target;
+  GLsizeiptr RegionSize;
+  GLsizeiptr Alignment;
+  BufferHandle Buffer;
+  GLuint BufferId;
+  GLubyte *Mapped;
+  GLsync Fences[REGIONS];
+  int Region;
+  GLsizeiptr Head;
+  unsigned Stalls;
+
+  void wait(GLsync &fence);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_STREAM_BUFFER_HPP */
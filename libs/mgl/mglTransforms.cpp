@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Structure-of-Arrays Transform Store
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglTransforms.hpp"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MGL_TRANSFORMS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) ||                                  \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MGL_TRANSFORMS_SSE
+#endif
+
+namespace mgl {
+
+///////////////////////////////////////////////////////////////// TransformStore
+
+// Positions, rotation quaternions and scales are kept in structure-of-arrays
+// layout and compose() turns them into T * R * S world matrices in batches:
+// 8 at a time with AVX2 when the compiler targets it (/arch:AVX2, -mavx2), 4
+// at a time with SSE2 on any x86-64 build, and one at a time otherwise and
+// for the remainder. The kernel is chosen at compile time. Rotations are
+// expected to be unit quaternions; an angle about a zero axis is the identity.
+
+TransformStore::TransformStore() {}
+
+TransformStore::~TransformStore() {}
+
+const char *TransformStore::getKernel() {
+#if defined(MGL_TRANSFORMS_AVX2)
+  return "AVX2";
+#elif defined(MGL_TRANSFORMS_SSE)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+TransformStore::TransformId TransformStore::add(const glm::vec3 &position,
+                                                const glm::quat &rotation,
+                                                const glm::vec3 &scale) {
+  PX.push_back(position.x);
+  PY.push_back(position.y);
+  PZ.push_back(position.z);
+  QX.push_back(rotation.x);
+  QY.push_back(rotation.y);
+  QZ.push_back(rotation.z);
+  QW.push_back(rotation.w);
+  SX.push_back(scale.x);
+  SY.push_back(scale.y);
+  SZ.push_back(scale.z);
+  Matrices.push_back(glm::mat4(1.0f));
+  return static_cast<TransformId>(Matrices.size() - 1);
+}
+
+void TransformStore::setPosition(const TransformId id,
+                                 const glm::vec3 &position) {
+  PX[id] = position.x;
+  PY[id] = position.y;
+  PZ[id] = position.z;
+}
+
+void TransformStore::setRotation(const TransformId id,
+                                 const glm::quat &rotation) {
+  QX[id] = rotation.x;
+  QY[id] = rotation.y;
+  QZ[id] = rotation.z;
+  QW[id] = rotation.w;
+}
+
+void TransformStore::setRotation(const TransformId id, const float angle,
+                                 const glm::vec3 &axis) {
+  const float length =
+      std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+  if (length <= 0.0f) {
+    setRotation(id, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    return;
+  }
+  const float s = std::sin(angle * 0.5f) / length;
+  QX[id] = axis.x * s;
+  QY[id] = axis.y * s;
+  QZ[id] = axis.z * s;
+  QW[id] = std::cos(angle * 0.5f);
+}
+
+void TransformStore::setScale(const TransformId id, const glm::vec3 &scale) {
+  SX[id] = scale.x;
+  SY[id] = scale.y;
+  SZ[id] = scale.z;
+}
+
+const glm::mat4 &TransformStore::getMatrix(const TransformId id) const {
+  return Matrices[id];
+}
+
+const glm::mat4 *TransformStore::getMatrices() const {
+  return Matrices.data();
+}
+
+size_t TransformStore::size() const { return Matrices.size(); }
+
+void TransformStore::clear() {
+  for (std::vector<float> *v : {&PX, &PY, &PZ, &QX, &QY, &QZ, &QW, &SX, &SY,
+                                 &SZ}) {
+    v->clear();
+  }
+  Matrices.clear();
+}
+
+void TransformStore::compose() {
+  const size_t done = composeSimd();
+  composeScalar(done, Matrices.size());
+}
+
+void TransformStore::composeScalar(const size_t begin, const size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    const float x = QX[i], y = QY[i], z = QZ[i], w = QW[i];
+    float *m = &Matrices[i][0][0];
+    m[0] = (1.0f - 2.0f * (y * y + z * z)) * SX[i];
+    m[1] = 2.0f * (x * y + w * z) * SX[i];
+    m[2] = 2.0f * (x * z - w * y) * SX[i];
+    m[3] = 0.0f;
+    m[4] = 2.0f * (x * y - w * z) * SY[i];
+    m[5] = (1.0f - 2.0f * (x * x + z * z)) * SY[i];
+    m[6] = 2.0f * (y * z + w * x) * SY[i];
+    m[7] = 0.0f;
+    m[8] = 2.0f * (x * z + w * y) * SZ[i];
+    m[9] = 2.0f * (y * z - w * x) * SZ[i];
+    m[10] = (1.0f - 2.0f * (x * x + y * y)) * SZ[i];
+    m[11] = 0.0f;
+    m[12] = PX[i];
+    m[13] = PY[i];
+    m[14] = PZ[i];
+    m[15] = 1.0f;
+  }
+}
+
+#if defined(MGL_TRANSFORMS_SSE) || defined(MGL_TRANSFORMS_AVX2)
+
+// Transposes four lanes of (x, y, z, w) columns into one column per matrix
+// and stores column 'c' of four consecutive matrices.
+static inline void storeColumns(float *m, const int c, __m128 x, __m128 y,
+                                __m128 z, __m128 w) {
+  _MM_TRANSPOSE4_PS(x, y, z, w);
+  _mm_storeu_ps(m + c * 4, x);
+  _mm_storeu_ps(m + 16 + c * 4, y);
+  _mm_storeu_ps(m + 32 + c * 4, z);
+  _mm_storeu_ps(m + 48 + c * 4, w);
+}
+
+#endif
+
+#if defined(MGL_TRANSFORMS_AVX2)
+
+size_t TransformStore::composeSimd() {
+  const size_t n = Matrices.size() & ~static_cast<size_t>(7);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  for (size_t i = 0; i < n; i += 8) {
+    const __m256 x = _mm256_loadu_ps(&QX[i]), y = _mm256_loadu_ps(&QY[i]),
+                 z = _mm256_loadu_ps(&QZ[i]), w = _mm256_loadu_ps(&QW[i]);
+    const __m256 sx = _mm256_loadu_ps(&SX[i]), sy = _mm256_loadu_ps(&SY[i]),
+                 sz = _mm256_loadu_ps(&SZ[i]);
+    const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y),
+                 zz = _mm256_mul_ps(z, z), xy = _mm256_mul_ps(x, y),
+                 xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z),
+                 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y),
+                 wz = _mm256_mul_ps(w, z);
+    __m256 c[16];
+    c[0] = _mm256_mul_ps(
+        _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx);
+    c[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+    c[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+    c[3] = _mm256_setzero_ps();
+    c[4] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+    c[5] = _mm256_mul_ps(
+        _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy);
+    c[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+    c[7] = _mm256_setzero_ps();
+    c[8] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+    c[9] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+    c[10] = _mm256_mul_ps(
+        _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz);
+    c[11] = _mm256_setzero_ps();
+    c[12] = _mm256_loadu_ps(&PX[i]);
+    c[13] = _mm256_loadu_ps(&PY[i]);
+    c[14] = _mm256_loadu_ps(&PZ[i]);
+    c[15] = one;
+    float *m = &Matrices[i][0][0];
+    for (int k = 0; k < 4; ++k) {
+      storeColumns(m, k, _mm256_castps256_ps128(c[k * 4]),
+                   _mm256_castps256_ps128(c[k * 4 + 1]),
+                   _mm256_castps256_ps128(c[k * 4 + 2]),
+                   _mm256_castps256_ps128(c[k * 4 + 3]));
+      storeColumns(m + 64, k, _mm256_extractf128_ps(c[k * 4], 1),
+                   _mm256_extractf128_ps(c[k * 4 + 1], 1),
+                   _mm256_extractf128_ps(c[k * 4 + 2], 1),
+                   _mm256_extractf128_ps(c[k * 4 + 3], 1));
+    }
+  }
+  return n;
+}
+
+#elif defined(MGL_TRANSFORMS_SSE)
+
+size_t TransformStore::composeSimd() {
+  const size_t n = Matrices.size() & ~static_cast<size_t>(3);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 zero = _mm_setzero_ps();
+  for (size_t i = 0; i < n; i += 4) {
+    const __m128 x = _mm_loadu_ps(&QX[i]), y = _mm_loadu_ps(&QY[i]),
+                 z = _mm_loadu_ps(&QZ[i]), w = _mm_loadu_ps(&QW[i]);
+    const __m128 sx = _mm_loadu_ps(&SX[i]), sy = _mm_loadu_ps(&SY[i]),
+                 sz = _mm_loadu_ps(&SZ[i]);
+    const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y),
+                 zz = _mm_mul_ps(z, z), xy = _mm_mul_ps(x, y),
+                 xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z),
+                 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y),
+                 wz = _mm_mul_ps(w, z);
+    float *m = &Matrices[i][0][0];
+    storeColumns(
+        m, 0,
+        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx), zero);
+    storeColumns(
+        m, 1, _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy), zero);
+    storeColumns(
+        m, 2, _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+        zero);
+    storeColumns(m, 3, _mm_loadu_ps(&PX[i]), _mm_loadu_ps(&PY[i]),
+                 _mm_loadu_ps(&PZ[i]), one);
+  }
+  return n;
+}
+
+#else
+
+size_t TransformStore::composeSimd() { return 0; }
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Structure-of-Arrays Transform Store
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_TRANSFORMS_HPP
+#define MGL_TRANSFORMS_HPP
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mgl {
+
+class TransformStore;
+
+///////////////////////////////////////////////////////////////// TransformStore
+
+class TransformStore final {
+public:
+  typedef uint32_t TransformId;
+
+  TransformStore();
+  ~TransformStore();
+
+  TransformId add(const glm::vec3 &position, const glm::quat &rotation,
+                  const glm::vec3 &scale);
+  void setPosition(const TransformId id, const glm::vec3 &position);
+  void setRotation(const TransformId id, const glm::quat &rotation);
+  void setRotation(const TransformId id, const float angle,
+                   const glm::vec3 &axis);
+  void setScale(const TransformId id, const glm::vec3 &scale);
+  void compose();
+  const glm::mat4 &getMatrix(const TransformId id) const;
+  const glm::mat4 *getMatrices() const;
+  size_t size() const;
+  void clear();
+
+  static const char *getKernel();
+
+private:
+  std::vector<float> PX, PY, PZ;
+  std::vector<float> QX, QY, QZ, QW;
+  std::vector<float> SX, SY, SZ;
+  std::vector<glm::mat4> Matrices;
+
+  void composeScalar(const size_t begin, const size_t end);
+  size_t composeSimd();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_TRANSFORMS_HPP */
@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Vertex Format Descriptors
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "./mglVertexFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "./mglState.hpp"
+
+namespace mgl {
+
+/////////////////////////////////////////////////////////////////// VertexFormat
+
+// Describes an interleaved vertex layout. Attributes are laid out in the
+// order they are added, each starting on a 4-byte boundary as recommended by
+// the GL, and pack() converts full precision values into the stored type so
+// vertex data can be written without hand-rolled bit twiddling. The add*()
+// presets pick compact encodings:
+//
+//   position  3 x GL_HALF_FLOAT                      8 bytes (w fetched as 1)
+//   normal    GL_INT_2_10_10_10_REV, normalized      4 bytes
+//   color     4 x GL_UNSIGNED_BYTE, normalized       4 bytes
+//   texcoord  2 x GL_UNSIGNED_SHORT, normalized      4 bytes
+//
+// against 16 bytes per attribute for vec4 floats. Half positions have 11 bits
+// of precision, so they suit model space data of moderate extent; use
+// add(index, 3, GL_FLOAT) where that is not enough.
+
+VertexFormat::VertexFormat() : Stride(0) {}
+
+VertexFormat::~VertexFormat() {}
+
+GLuint VertexFormat::attributeSize(const GLint size, const GLenum type) {
+  switch (type) {
+  case GL_BYTE:
+  case GL_UNSIGNED_BYTE:
+    return size;
+  case GL_SHORT:
+  case GL_UNSIGNED_SHORT:
+  case GL_HALF_FLOAT:
+    return 2 * size;
+  case GL_INT:
+  case GL_UNSIGNED_INT:
+  case GL_FLOAT:
+    return 4 * size;
+  case GL_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+    return 4;
+  default:
+    std::cerr << "Unsupported vertex attribute type " << type << "."
+              << std::endl;
+    throw std::runtime_error("Unsupported vertex attribute type.");
+  }
+}
+
+VertexFormat &VertexFormat::add(const GLuint index, const GLint size,
+                                const GLenum type,
+                                const GLboolean normalized) {
+  const GLuint offset = static_cast<GLuint>(Stride);
+  Attributes.push_back({index, size, type, normalized, offset});
+  Stride += (attributeSize(size, type) + 3) & ~3u;
+  return *this;
+}
+
+VertexFormat &VertexFormat::addPosition(const GLuint index) {
+  return add(index, 3, GL_HALF_FLOAT);
+}
+
+VertexFormat &VertexFormat::addNormal(const GLuint index) {
+  return add(index, 4, GL_INT_2_10_10_10_REV, GL_TRUE);
+}
+
+VertexFormat &VertexFormat::addColor(const GLuint index) {
+  return add(index, 4, GL_UNSIGNED_BYTE, GL_TRUE);
+}
+
+VertexFormat &VertexFormat::addTexcoord(const GLuint index) {
+  return add(index, 2, GL_UNSIGNED_SHORT, GL_TRUE);
+}
+
+GLsizei VertexFormat::getStride() const { return Stride; }
+
+const std::vector<VertexFormat::Attribute> &
+VertexFormat::getAttributes() const {
+  return Attributes;
+}
+
+// Round to nearest even, with overflow to infinity and gradual underflow.
+GLushort VertexFormat::toHalf(const GLfloat value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs = bits & 0x7FFFFFFF;
+  uint32_t half;
+  if (abs >= 0x7F800000) {
+    half = 0x7C00 | (abs > 0x7F800000 ? 0x200 : 0);
+  } else if (abs >= 0x477FF000) {
+    half = 0x7C00;
+  } else if (abs >= 0x38800000) {
+    half = (abs - 0x38000000) >> 13;
+    const uint32_t rest = abs & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+      half++;
+  } else if (abs >= 0x33000000) {
+    const uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+    const uint32_t shift = 126 - (abs >> 23);
+    half = mantissa >> shift;
+    const uint32_t rest = mantissa & ((1u << shift) - 1);
+    const uint32_t midpoint = 1u << (shift - 1);
+    if (rest > midpoint || (rest == midpoint && (half & 1)))
+      half++;
+  } else {
+    half = 0;
+  }
+  return static_cast<GLushort>(sign | half);
+}
+
+// Scaled in double precision so that 32-bit scales stay exact.
+static GLint snorm(const GLfloat value, const double scale) {
+  return static_cast<GLint>(
+      std::round(std::min(std::max(double(value), -1.0), 1.0) * scale));
+}
+
+static GLuint unorm(const GLfloat value, const double scale) {
+  return static_cast<GLuint>(
+      std::round(std::min(std::max(double(value), 0.0), 1.0) * scale));
+}
+
+// Signed normalized x, y, z in 10 bits each and w in 2, as fetched by
+// GL_INT_2_10_10_10_REV (OpenGL 4.2 conversion rules).
+GLuint VertexFormat::toSnorm1010102(const glm::vec4 &value) {
+  const GLuint x = static_cast<GLuint>(snorm(value.x, 511.0f)) & 0x3FF;
+  const GLuint y = static_cast<GLuint>(snorm(value.y, 511.0f)) & 0x3FF;
+  const GLuint z = static_cast<GLuint>(snorm(value.z, 511.0f)) & 0x3FF;
+  const GLuint w = static_cast<GLuint>(snorm(value.w, 1.0f)) & 0x3;
+  return x | (y << 10) | (z << 20) | (w << 30);
+}
+
+// Unsigned normalized x, y, z in 10 bits each and w in 2, as fetched by
+// GL_UNSIGNED_INT_2_10_10_10_REV.
+GLuint VertexFormat::toUnorm1010102(const glm::vec4 &value) {
+  const GLuint x = unorm(value.x, 1023.0);
+  const GLuint y = unorm(value.y, 1023.0);
+  const GLuint z = unorm(value.z, 1023.0);
+  const GLuint w = unorm(value.w, 3.0);
+  return x | (y << 10) | (z << 20) | (w << 30);
+}
+
+// Non-normalized packed components are fetched as the integer values
+// themselves, converted to float.
+static GLuint toInt1010102(const glm::vec4 &value) {
+  const GLuint x = static_cast<GLuint>(static_cast<GLint>(value.x)) & 0x3FF;
+  const GLuint y = static_cast<GLuint>(static_cast<GLint>(value.y)) & 0x3FF;
+  const GLuint z = static_cast<GLuint>(static_cast<GLint>(value.z)) & 0x3FF;
+  const GLuint w = static_cast<GLuint>(static_cast<GLint>(value.w)) & 0x3;
+  return x | (y << 10) | (z << 20) | (w << 30);
+}
+
+void VertexFormat::pack(GLubyte *vertex, const size_t attribute,
+                        const glm::vec4 &value) const {
+  const Attribute &a = Attributes[attribute];
+  GLubyte *dst = vertex + a.offset;
+  const bool n = a.normalized == GL_TRUE;
+  for (GLint i = 0; i < a.size; ++i) {
+    const GLfloat v = value[i];
+    switch (a.type) {
+    case GL_FLOAT:
+      std::memcpy(dst + 4 * i, &v, 4);
+      break;
+    case GL_HALF_FLOAT: {
+      const GLushort h = toHalf(v);
+      std::memcpy(dst + 2 * i, &h, 2);
+      break;
+    }
+    case GL_UNSIGNED_BYTE:
+      dst[i] = static_cast<GLubyte>(n ? unorm(v, 255.0f) : v);
+      break;
+    case GL_BYTE:
+      dst[i] = static_cast<GLubyte>(
+          static_cast<GLbyte>(n ? snorm(v, 127.0f) : v));
+      break;
+    case GL_UNSIGNED_SHORT: {
+      const GLushort s = static_cast<GLushort>(n ? unorm(v, 65535.0f) : v);
+      std::memcpy(dst + 2 * i, &s, 2);
+      break;
+    }
+    case GL_SHORT: {
+      const GLshort s = static_cast<GLshort>(n ? snorm(v, 32767.0f) : v);
+      std::memcpy(dst + 2 * i, &s, 2);
+      break;
+    }
+    case GL_UNSIGNED_INT: {
+      const GLuint u = n ? unorm(v, 4294967295.0) : static_cast<GLuint>(v);
+      std::memcpy(dst + 4 * i, &u, 4);
+      break;
+    }
+    case GL_INT: {
+      const GLint s = n ? snorm(v, 2147483647.0) : static_cast<GLint>(v);
+      std::memcpy(dst + 4 * i, &s, 4);
+      break;
+    }
+    case GL_INT_2_10_10_10_REV: {
+      const GLuint p = n ? toSnorm1010102(value) : toInt1010102(value);
+      std::memcpy(dst, &p, 4);
+      return;
+    }
+    case GL_UNSIGNED_INT_2_10_10_10_REV: {
+      const GLuint p = n ? toUnorm1010102(value) : toInt1010102(value);
+      std::memcpy(dst, &p, 4);
+      return;
+    }
+    default:
+      std::memcpy(dst + 4 * i, &v, 4);
+      break;
+    }
+  }
+}
+
+// Whether an attribute is fetched as an integer (glVertexAttribIPointer)
+// rather than converted to float: only non-normalized plain integer types
+// are. Packed 10-10-10-2 types are always converted.
+bool VertexFormat::isInteger(const GLenum type, const GLboolean normalized) {
+  return !(type == GL_FLOAT || type == GL_HALF_FLOAT || type == GL_DOUBLE ||
+           type == GL_FIXED || normalized || type == GL_INT_2_10_10_10_REV ||
+           type == GL_UNSIGNED_INT_2_10_10_10_REV);
+}
+
+// Sets up the attributes of a VAO for this format, reading from buffer
+// starting at offset. Non-normalized integer types stay integers in the
+// shader. With direct state access (OpenGL 4.5) the format is described on
+// vertex buffer binding 0 of the VAO without binding anything; otherwise the
+// VAO and buffer are bound through the StateCache, attribute pointers are
+// used and the previously bound VAO is restored.
+void VertexFormat::apply(const GLuint vao, const GLuint buffer,
+                         const GLintptr offset) const {
+  if (StateCache::hasDirectStateAccess()) {
+    glVertexArrayVertexBuffer(vao, 0, buffer, offset, Stride);
+    for (const Attribute &a : Attributes) {
+      glEnableVertexArrayAttrib(vao, a.index);
+      if (isInteger(a.type, a.normalized)) {
+        glVertexArrayAttribIFormat(vao, a.index, a.size, a.type, a.offset);
+      } else {
+        glVertexArrayAttribFormat(vao, a.index, a.size, a.type, a.normalized,
+                                  a.offset);
+      }
+      glVertexArrayAttribBinding(vao, a.index, 0);
+    }
+    return;
+  }
+  StateCache &state = StateCache::getInstance();
+  const GLuint previous = state.getVertexArray();
+  state.bindVertexArray(vao);
+  state.bindBuffer(GL_ARRAY_BUFFER, buffer);
+  for (const Attribute &a : Attributes) {
+    const GLintptr start = offset + a.offset;
+    glEnableVertexAttribArray(a.index);
+    if (isInteger(a.type, a.normalized)) {
+      glVertexAttribIPointer(a.index, a.size, a.type, Stride,
+                             reinterpret_cast<GLvoid *>(start));
+    } else {
+      glVertexAttribPointer(a.index, a.size, a.type, a.normalized, Stride,
+                            reinterpret_cast<GLvoid *>(start));
+    }
+  }
+  state.bindVertexArray(previous == StateCache::UNKNOWN ? 0 : previous);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
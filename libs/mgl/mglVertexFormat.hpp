@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Vertex Format Descriptors
+//
+// Copyright (c)2022-25 by Carlos Martinho
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MGL_VERTEX_FORMAT_HPP
+#define MGL_VERTEX_FORMAT_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace mgl {
+
+class VertexFormat;
+
+/////////////////////////////////////////////////////////////////// VertexFormat
+
+class VertexFormat final {
+public:
+  struct Attribute {
+    GLuint index;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLuint offset;
+  };
+
+  VertexFormat();
+  ~VertexFormat();
+
+  VertexFormat &add(const GLuint index, const GLint size, const GLenum type,
+                    const GLboolean normalized = GL_FALSE);
+  VertexFormat &addPosition(const GLuint index);
+  VertexFormat &addNormal(const GLuint index);
+  VertexFormat &addColor(const GLuint index);
+  VertexFormat &addTexcoord(const GLuint index);
+
+  GLsizei getStride() const;
+  const std::vector<Attribute> &getAttributes() const;
+
+  void pack(GLubyte *vertex, const size_t attribute,
+            const glm::vec4 &value) const;
+  void apply(const GLuint vao, const GLuint buffer,
+             const GLintptr offset = 0) const;
+
+  static GLuint attributeSize(const GLint size, const GLenum type);
+  static bool isInteger(const GLenum type, const GLboolean normalized);
+  static GLushort toHalf(const GLfloat value);
+  static GLuint toSnorm1010102(const glm::vec4 &value);
+  static GLuint toUnorm1010102(const glm::vec4 &value);
+
+private:
+  std::vector<Attribute> Attributes;
+  GLsizei Stride;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace mgl
+
+#endif /* MGL_VERTEX_FORMAT_HPP */